@@ -0,0 +1,944 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// QOffice - The office framework for Qt
+// Copyright (C) 2016-2018 Nicolas Kogler
+//
+// This file is part of the Widget module.
+//
+// QOffice is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// QOffice is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with QOffice. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QOffice/Widgets/Dialogs/OfficeWindow.hpp>
+#include <QOffice/Widgets/MenuItems/OfficeMenuDropdownItem.hpp>
+#include <QOffice/Widgets/MenuItems/OfficeMenuFontPickerItem.hpp>
+#include <QOffice/Widgets/MenuItems/OfficeMenuGalleryItem.hpp>
+#include <QOffice/Widgets/MenuItems/OfficeMenuTextboxItem.hpp>
+#include <QOffice/Widgets/OfficeLineEdit.hpp>
+#include <QOffice/Widgets/OfficeMenu.hpp>
+#include <QOffice/Widgets/OfficeMenuCommandExecutor.hpp>
+#include <QOffice/Widgets/OfficeMenuHeader.hpp>
+#include <QOffice/Widgets/OfficeMenuLoader.hpp>
+#include <QOffice/Widgets/OfficeMenuPanel.hpp>
+#include <QOffice/Widgets/OfficeMenuPanelBar.hpp>
+#include <QOffice/Widgets/OfficeMenuSearchIndex.hpp>
+#include <QOffice/Widgets/OfficeTooltip.hpp>
+#include <QOffice/Widgets/OfficeWindowMenuItem.hpp>
+
+#include <QAbstractListModel>
+#include <QApplication>
+#include <QBoxLayout>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFontDatabase>
+#include <QGraphicsOpacityEffect>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QListView>
+#include <QScrollBar>
+#include <QStringListModel>
+#include <QTest>
+#include <QTextStream>
+#include <QThread>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <new>
+
+// Counts every heap allocation of the process. On platforms with ELF symbol
+// interposition this includes allocations made inside the QOffice and Qt
+// libraries; on Windows only the allocations of this executable are seen.
+static std::atomic<quint64> g_allocations(0);
+
+void* operator new(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+
+    void* memory = std::malloc(size == 0 ? 1 : size);
+    if (memory == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    return memory;
+}
+
+void operator delete(void* memory) QOFFICE_NOEXCEPT
+{
+    std::free(memory);
+}
+
+// Counts the paint events delivered to any widget.
+class PaintCounter : public QObject
+{
+public:
+
+    quint64 count = 0;
+
+protected:
+
+    bool eventFilter(QObject* watched, QEvent* event) override
+    {
+        if (event->type() == QEvent::Paint)
+        {
+            count++;
+        }
+
+        return QObject::eventFilter(watched, event);
+    }
+};
+
+struct Scenario
+{
+    const char*           name;
+    std::function<void()> run;
+};
+
+// Holds additional metrics of the running scenario, which are merged into its
+// result, e.g. latencies of single operations.
+static QJsonObject g_metrics;
+
+static double percentile(QVector<qint64> samples, double fraction)
+{
+    if (samples.isEmpty())
+    {
+        return 0.0;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    const int index = qMin(samples.size() - 1, static_cast<int>(samples.size() * fraction));
+
+    return samples.at(index) / 1000000.0;
+}
+
+static OfficeWindow* createWindow()
+{
+    OfficeWindow* window = new OfficeWindow;
+    window->resize(800, 600);
+    window->setWindowTitle("Scenario");
+    window->setLayout(new QVBoxLayout);
+    window->show();
+
+    QTest::qWaitForWindowExposed(window);
+
+    return window;
+}
+
+static void windowResizeSweep()
+{
+    QScopedPointer<OfficeWindow> window(createWindow());
+    priv::Titlebar* titlebar = window->findChild<priv::Titlebar*>();
+
+    for (int width = 600; width <= 1400; width += 8)
+    {
+        window->resize(width, width * 3 / 4);
+        QApplication::processEvents();
+    }
+
+    // Sweeps the mouse along the titlebar, across the window buttons.
+    for (int x = 0; x < titlebar->width(); x += 2)
+    {
+        QTest::mouseMove(titlebar, QPoint(x, titlebar->height() / 2));
+        QApplication::processEvents();
+    }
+}
+
+static void windowMaximizeToggle()
+{
+    QScopedPointer<OfficeWindow> window(createWindow());
+
+    for (int i = 0; i < 100; i++)
+    {
+        if (window->isMaximized())
+        {
+            window->showNormal();
+        }
+        else
+        {
+            window->showMaximized();
+        }
+
+        QApplication::processEvents();
+    }
+}
+
+static void menuExpandCollapse()
+{
+    QScopedPointer<OfficeWindow> window(createWindow());
+    OfficeMenu* menu = new OfficeMenu(window.data());
+    window->layout()->addWidget(menu);
+
+    for (int h = 0; h < 12; h++)
+    {
+        OfficeMenuHeader* header = menu->appendHeader(h, QString("Header %1").arg(h));
+        for (int p = 0; p < 4; p++)
+        {
+            OfficeMenuPanel* panel = header->appendPanel(p, QString("Panel %1").arg(p));
+            for (int i = 0; i < 3; i++)
+            {
+                panel->insertItem(i, new OfficeMenuTextboxItem("Text"), i, 0);
+            }
+        }
+    }
+
+    QApplication::processEvents();
+
+    for (int i = 0; i < 1000; i++)
+    {
+        menu->expand(menu->headerById(i % 12));
+        QApplication::processEvents();
+        menu->collapse();
+        QApplication::processEvents();
+    }
+}
+
+static void menuBuild10k()
+{
+    QScopedPointer<OfficeWindow> window(createWindow());
+    OfficeMenu* menu = new OfficeMenu(window.data());
+    window->layout()->addWidget(menu);
+
+    // Builds 10 headers with 20 panels of 50 items each. Item IDs are unique
+    // across the whole menu so that every one of them can be looked up below.
+    int id = 0;
+    for (int h = 0; h < 10; h++)
+    {
+        OfficeMenuHeader* header = menu->appendHeader(h, QString("Header %1").arg(h));
+        for (int p = 0; p < 20; p++)
+        {
+            OfficeMenuPanel* panel = header->appendPanel(p, QString("Panel %1").arg(p));
+            for (int i = 0; i < 50; i++, id++)
+            {
+                panel->insertItem(id, new OfficeMenuTextboxItem("Text"), i % 3, i / 3);
+            }
+        }
+    }
+
+    for (int i = 0; i < id; i++)
+    {
+        menu->itemById(-1, -1, i);
+        menu->itemById(i % 10, (i / 50) % 20, i);
+    }
+
+    QApplication::processEvents();
+}
+
+static void menuLoad10k()
+{
+    QScopedPointer<OfficeWindow> window(createWindow());
+    OfficeMenu* menu = new OfficeMenu(window.data());
+    window->layout()->addWidget(menu);
+
+    // Describes the same ribbon as menuBuild10k, but loads it in one pass.
+    QJsonArray headers;
+    for (int h = 0, id = 0; h < 10; h++)
+    {
+        QJsonArray panels;
+        for (int p = 0; p < 20; p++)
+        {
+            QJsonArray items;
+            for (int i = 0; i < 50; i++, id++)
+            {
+                items.append(QJsonObject {
+                    { "id", id }, { "type", "textbox" }, { "text", "Text" },
+                    { "row", i % 3 }, { "column", i / 3 }
+                    });
+            }
+
+            panels.append(QJsonObject {
+                { "id", p }, { "text", QString("Panel %1").arg(p) }, { "items", items }
+                });
+        }
+
+        headers.append(QJsonObject {
+            { "id", h }, { "text", QString("Header %1").arg(h) }, { "panels", panels }
+            });
+    }
+
+    const QByteArray definition = QJsonDocument(QJsonObject {{ "headers", headers }}).toJson();
+
+    OfficeMenuLoader loader;
+    loader.load(menu, definition);
+
+    QApplication::processEvents();
+}
+
+static void menuLazyBuild()
+{
+    QScopedPointer<OfficeWindow> window(createWindow());
+    OfficeMenu* menu = new OfficeMenu(window.data());
+    window->layout()->addWidget(menu);
+
+    // Same ribbon as in menuExpandCollapse, but only declared. Just two of the
+    // twelve headers are ever expanded, like most users do.
+    for (int h = 0; h < 12; h++)
+    {
+        OfficeMenuHeader* header = menu->appendHeader(h, QString("Header %1").arg(h));
+        for (int p = 0; p < 4; p++)
+        {
+            header->declarePanel(p, QString("Panel %1").arg(p));
+            for (int i = 0; i < 3; i++)
+            {
+                header->declareItem(p, i, [] { return new OfficeMenuTextboxItem("Text"); }, i, 0);
+            }
+        }
+    }
+
+    QApplication::processEvents();
+
+    for (int i = 0; i < 100; i++)
+    {
+        menu->expand(menu->headerById(i % 2));
+        QApplication::processEvents();
+        menu->collapse();
+        QApplication::processEvents();
+    }
+}
+
+static void menuBatchRebuild()
+{
+    QScopedPointer<OfficeWindow> window(createWindow());
+    OfficeMenu* menu = new OfficeMenu(window.data());
+    window->layout()->addWidget(menu);
+
+    OfficeMenuHeader* header = menu->appendHeader(0, "Context");
+    menu->setPinned(true);
+    menu->expand(header);
+    QApplication::processEvents();
+
+    // Rebuilds a context-sensitive tab on every simulated selection change.
+    for (int i = 0; i < 200; i++)
+    {
+        menu->beginUpdate();
+
+        for (int p = 0; p < 4; p++)
+        {
+            header->removePanel(p);
+
+            OfficeMenuPanel* panel = header->appendPanel(p, QString("Panel %1").arg(p));
+            for (int j = 0; j < 6; j++)
+            {
+                panel->insertItem(j, new OfficeMenuTextboxItem("Text"), j % 3, j / 3);
+            }
+        }
+
+        menu->endUpdate();
+        QApplication::processEvents();
+    }
+}
+
+static void panelBarRepaint(bool withEffect)
+{
+    QScopedPointer<OfficeWindow> window(createWindow());
+    OfficeMenu* menu = new OfficeMenu(window.data());
+    window->layout()->addWidget(menu);
+
+    OfficeMenuHeader* header = menu->appendHeader(0, "Home");
+    for (int p = 0; p < 4; p++)
+    {
+        OfficeMenuPanel* panel = header->appendPanel(p, QString("Panel %1").arg(p));
+        for (int i = 0; i < 6; i++)
+        {
+            panel->insertItem(i, new OfficeMenuTextboxItem("Text"), i % 3, i / 3);
+        }
+    }
+
+    menu->setPinned(true);
+    menu->expand(header);
+    QTest::qWait(300);
+
+    // Reproduces the permanent opacity effect the panel bar used to carry, to
+    // compare the repaint cost of a single item with and without it.
+    priv::PanelBar* panelBar = menu->findChild<priv::PanelBar*>();
+    if (withEffect)
+    {
+        panelBar->setGraphicsEffect(new QGraphicsOpacityEffect(panelBar));
+    }
+
+    const auto items = panelBar->findChildren<OfficeMenuTextboxItem*>();
+    for (int i = 0; i < 2000; i++)
+    {
+        items.at(i % items.size())->update();
+        QApplication::processEvents();
+    }
+}
+
+static void panelBarAdaptiveResize()
+{
+    QScopedPointer<OfficeWindow> window(createWindow());
+    OfficeMenu* menu = new OfficeMenu(window.data());
+    window->layout()->addWidget(menu);
+    menu->setPinned(true);
+
+    OfficeMenuHeader* header = menu->appendHeader(0, "Home");
+    for (int p = 0; p < 16; p++)
+    {
+        OfficeMenuPanel* panel = header->appendPanel(p, QString("Panel %1").arg(p));
+        for (int i = 0; i < 6; i++)
+        {
+            panel->insertItem(i, new OfficeMenuTextboxItem("Text"), i % 3, i / 3);
+        }
+    }
+
+    menu->expand(header);
+    QTest::qWait(250);
+
+    // Shrinks the window until most panels are collapsed and grows it again.
+    for (int width = 1600; width >= 300; width -= 8)
+    {
+        window->resize(width, 600);
+        QApplication::processEvents();
+    }
+
+    for (int width = 300; width <= 1600; width += 8)
+    {
+        window->resize(width, 600);
+        QApplication::processEvents();
+    }
+}
+
+static void menuEventDispatch(bool routed)
+{
+    QScopedPointer<OfficeWindow> window(createWindow());
+    OfficeMenu* menu = new OfficeMenu(window.data());
+    window->layout()->addWidget(menu);
+
+    OfficeMenuPanel* panel = menu->appendHeader(0, "Home")->appendPanel(0, "Panel");
+    for (int i = 0; i < 200; i++)
+    {
+        panel->insertItem(i, new OfficeMenuTextboxItem, i % 3, i / 3);
+    }
+
+    // Registers one handler per item, either through the routing table or as
+    // a slot that has to filter the events by ID itself.
+    int handled = 0;
+    for (int i = 0; i < 200; i++)
+    {
+        if (routed)
+        {
+            menu->subscribe(i, OfficeMenuEvent::TextChanged,
+                [&handled](OfficeMenuEvent*) { handled++; }
+                );
+        }
+        else
+        {
+            QObject::connect(menu, &OfficeMenu::textChangedEvent,
+                [&handled, i](OfficeMenuTextChangedEvent* event)
+                    {
+                        if (event->id() == i)
+                            handled++;
+                    });
+        }
+    }
+
+    // Only typed text generates events; QLineEdit::setText does not.
+    auto* item = static_cast<OfficeMenuTextboxItem*>(panel->itemById(0));
+    for (int i = 0; i < 20; i++)
+    {
+        QTest::keyClicks(item, QString(100, 'x'));
+    }
+}
+
+static void menuEventQueued()
+{
+    QScopedPointer<OfficeWindow> window(createWindow());
+    OfficeMenu* menu = new OfficeMenu(window.data());
+    window->layout()->addWidget(menu);
+
+    OfficeMenuPanel* panel = menu->appendHeader(0, "Home")->appendPanel(0, "Panel");
+    panel->insertItem(0, new OfficeMenuTextboxItem, 0, 0);
+
+    // Delivers every text event to a receiver living on a worker thread.
+    QThread thread;
+    QObject receiver;
+    std::atomic<int> received(0);
+
+    receiver.moveToThread(&thread);
+    thread.start();
+
+    QObject::connect(menu, &OfficeMenu::sharedItemEvent, &receiver,
+        [&received](OfficeMenuEventHandle event)
+            {
+                if (event->type() == OfficeMenuEvent::TextChanged)
+                    received++;
+            },
+        Qt::QueuedConnection
+        );
+
+    auto* item = static_cast<OfficeMenuTextboxItem*>(panel->itemById(0));
+    for (int i = 0; i < 20; i++)
+    {
+        QTest::keyClicks(item, QString(100, 'x'));
+    }
+
+    QTest::qWaitFor([&received]() { return received.load() >= 2000; });
+
+    thread.quit();
+    thread.wait();
+}
+
+static void menuCommandExecutor()
+{
+    QScopedPointer<OfficeWindow> window(createWindow());
+    OfficeMenu* menu = new OfficeMenu(window.data());
+    window->layout()->addWidget(menu);
+
+    OfficeMenuPanel* panel = menu->appendHeader(0, "Home")->appendPanel(0, "Panel");
+    panel->insertItem(0, new OfficeMenuTextboxItem, 0, 0);
+
+    // Runs a command that takes 20 ms per keystroke; without the executor
+    // typing 500 characters would block the GUI thread for ten seconds.
+    auto* executor = new OfficeMenuCommandExecutor(menu);
+    executor->registerCommand(0, OfficeMenuEvent::TextChanged,
+        [](const OfficeMenuEventHandle&, const std::atomic<bool>& cancelled)
+            {
+                QElapsedTimer timer;
+                timer.start();
+                while (!cancelled.load() && timer.elapsed() < 20)
+                {
+                    QThread::yieldCurrentThread();
+                }
+
+                return QVariant(!cancelled.load());
+            });
+
+    auto* item = static_cast<OfficeMenuTextboxItem*>(panel->itemById(0));
+    for (int i = 0; i < 50; i++)
+    {
+        QTest::keyClicks(item, QString(10, 'x'));
+        QApplication::processEvents();
+    }
+
+    QTest::qWaitFor([executor]() { return !executor->isBusy(0); });
+}
+
+static void menuSearch50k()
+{
+    // Builds 50 000 distinct command names from a small vocabulary.
+    const char* verbs[] = { "Insert", "Format", "Delete", "Show", "Align", "Merge", "Sort", "Export", "Protect", "Track" };
+    const char* nouns[] = { "Picture", "Table", "Chart", "Cells", "Comment", "Header", "Footer", "Column", "Row", "Shape" };
+    const char* extras[] = { "Left", "Right", "Above", "Below", "All", "Selection", "Page", "Sheet", "Document", "Range" };
+
+    OfficeMenuSearchIndex index;
+    int count = 0;
+    while (count < 50000)
+    {
+        const int n = count;
+        const QString text = QString("%1 %2 %3 %4")
+            .arg(verbs[n % 10])
+            .arg(nouns[(n / 10) % 10])
+            .arg(extras[(n / 100) % 10])
+            .arg(n / 1000);
+
+        // The index never dereferences the owners of its entries, hence a
+        // distinct fake pointer per entry suffices.
+        index.insert(text, reinterpret_cast<OfficeMenuHeader*>(quintptr(count + 1)));
+        count++;
+    }
+
+    // Types each query one character at a time, like a search box would, and
+    // times every keystroke on its own.
+    const QString queries[] = { "insert picture", "fmtcell", "delete row below 4", "xyz" };
+    QVector<qint64> latencies;
+    latencies.reserve(50 * 64);
+
+    QElapsedTimer timer;
+    for (int i = 0; i < 50; i++)
+    {
+        for (const auto& query : queries)
+        {
+            for (int length = 1; length <= query.size(); length++)
+            {
+                const QString prefix = query.left(length);
+
+                timer.start();
+                index.search(prefix);
+                latencies.append(timer.nsecsElapsed());
+            }
+        }
+    }
+
+    g_metrics["keystrokes"] = latencies.size();
+    g_metrics["keystrokeP99Ms"] = percentile(latencies, 0.99);
+    g_metrics["keystrokeMaxMs"] = percentile(latencies, 1.0);
+}
+
+static void menuFocusChurn()
+{
+    QScopedPointer<OfficeWindow> window(createWindow());
+    OfficeMenu* menu = new OfficeMenu(window.data());
+    OfficeLineEdit* outside = new OfficeLineEdit(window.data());
+    window->layout()->addWidget(menu);
+    window->layout()->addWidget(outside);
+
+    QList<OfficeMenuTextboxItem*> items;
+    OfficeMenuHeader* header = menu->appendHeader(0, "Home");
+    for (int p = 0; p < 100; p++)
+    {
+        OfficeMenuPanel* panel = header->appendPanel(p, QString("Panel %1").arg(p));
+        for (int i = 0; i < 20; i++)
+        {
+            auto* item = new OfficeMenuTextboxItem;
+            panel->insertItem(i, item, i % 3, i / 3);
+            items.append(item);
+        }
+    }
+
+    menu->expand(header);
+    QTest::qWait(250);
+
+    // Moves the focus between items, which keeps the menu expanded, and out
+    // of the menu, which collapses it.
+    for (int i = 0; i < 500; i++)
+    {
+        items.at(i * 7 % items.size())->setFocus();
+        QApplication::processEvents();
+        items.at(i * 13 % items.size())->setFocus();
+        QApplication::processEvents();
+        outside->setFocus();
+        QApplication::processEvents();
+        menu->expand(header);
+    }
+}
+
+// Provides a thumbnail key for each of its rows without storing anything.
+class GalleryModel : public QAbstractListModel
+{
+public:
+
+    GalleryModel(int rows)
+        : m_rows(rows)
+    {
+    }
+
+    int rowCount(const QModelIndex& parent) const override
+    {
+        return parent.isValid() ? 0 : m_rows;
+    }
+
+    QVariant data(const QModelIndex& index, int role) const override
+    {
+        if (role == Qt::DisplayRole)
+            return QString("Style %1").arg(index.row());
+        if (role == OfficeMenuGalleryItem::ThumbnailRole)
+            return QString::number(index.row());
+
+        return QVariant();
+    }
+
+private:
+
+    int m_rows;
+};
+
+static void menuGalleryScroll(int rows)
+{
+    QScopedPointer<OfficeWindow> window(createWindow());
+    OfficeMenu* menu = new OfficeMenu(window.data());
+    window->layout()->addWidget(menu);
+    menu->setPinned(true);
+
+    GalleryModel model(rows);
+    auto* gallery = new OfficeMenuGalleryItem(&model);
+    gallery->setThumbnailLoader([](const QString& key, const QSize& size)
+        {
+            QImage image(size, QImage::Format_RGB32);
+            image.fill(QColor::fromHsv(key.toInt() % 360, 128, 224));
+            return image;
+        });
+
+    OfficeMenuHeader* header = menu->appendHeader(0, "Home");
+    header->appendPanel(0, "Styles")->insertItem(0, gallery, 0, 0, 3, 1);
+    menu->expand(header);
+    QTest::qWait(250);
+
+    // Scrolls the popup line by line through the first 100 lines of cells and
+    // selects a cell on each line.
+    gallery->showPopup();
+    QListView* view = gallery->findChildren<QListView*>().last();
+    for (int i = 0; i < 100 && i * 6 < rows; i++)
+    {
+        view->verticalScrollBar()->setValue(i);
+        QApplication::processEvents();
+        gallery->setCurrentRow(i * 6);
+    }
+
+    QTest::qWait(50);
+}
+
+static void menuDropdown100k()
+{
+    QScopedPointer<OfficeWindow> window(createWindow());
+    OfficeMenu* menu = new OfficeMenu(window.data());
+    window->layout()->addWidget(menu);
+    menu->setPinned(true);
+
+    QStringList entries;
+    entries.reserve(100000);
+    for (int i = 0; i < 100000; i++)
+    {
+        entries.append(QString("Entry %1").arg(i));
+    }
+
+    QStringListModel model(entries);
+    auto* dropdown = new OfficeMenuDropdownItem(&model);
+
+    OfficeMenuHeader* header = menu->appendHeader(0, "Home");
+    header->appendPanel(0, "Entries")->insertItem(0, dropdown, 0, 0);
+    menu->expand(header);
+    QTest::qWait(250);
+
+    // Opens the popup, types a prefix into it and chooses the match. Only the
+    // first type-ahead builds the prefix index; closing the popup resets the
+    // typed prefix.
+    QListView* view = dropdown->findChildren<QListView*>().last();
+    for (int i = 0; i < 50; i++)
+    {
+        dropdown->showPopup();
+        QApplication::processEvents();
+        QTest::keyClicks(view, QString("entry %1").arg(i * 1999));
+        QTest::keyClick(view, Qt::Key_Return);
+        QApplication::processEvents();
+    }
+}
+
+static void menuFontPicker1k()
+{
+    QScopedPointer<OfficeWindow> window(createWindow());
+    OfficeMenu* menu = new OfficeMenu(window.data());
+    window->layout()->addWidget(menu);
+    menu->setPinned(true);
+
+    // Pads the installed families with unknown ones, which resolve to the
+    // fallback face, up to a thousand rows.
+    QStringList families = QFontDatabase().families();
+    for (int i = families.size(); i < 1000; i++)
+    {
+        families.append(QString("Family %1").arg(i));
+    }
+
+    auto* picker = new OfficeMenuFontPickerItem(families.mid(0, 1000));
+    picker->setPreviewCapacity(1000);
+
+    OfficeMenuHeader* header = menu->appendHeader(0, "Home");
+    header->appendPanel(0, "Font")->insertItem(0, picker, 0, 0);
+    menu->expand(header);
+    QTest::qWait(250);
+
+    // Scrolls through the whole list three times, reopening the popup each
+    // time; the later rounds paint cached previews only.
+    QListView* view = picker->findChildren<QListView*>().last();
+    for (int round = 0; round < 3; round++)
+    {
+        picker->showPopup();
+        QApplication::processEvents();
+
+        QScrollBar* scrollBar = view->verticalScrollBar();
+        for (int value = 0; value <= scrollBar->maximum(); value += scrollBar->pageStep())
+        {
+            scrollBar->setValue(value);
+            QApplication::processEvents();
+        }
+
+        QTest::qWait(50);
+        picker->hidePopup();
+    }
+}
+
+static OfficeTooltip* findTooltip()
+{
+    // The tooltip manager creates its window the first time it is needed.
+    for (auto* widget : QApplication::topLevelWidgets())
+    {
+        if (auto* tooltip = qobject_cast<OfficeTooltip*>(widget))
+            return tooltip;
+    }
+
+    return nullptr;
+}
+
+static void tooltipStorm()
+{
+    QScopedPointer<OfficeWindow> window(createWindow());
+    for (int i = 0; i < 8; i++)
+    {
+        window->labelMenu()->addLabelItem(i, QString("Item %1").arg(i), "Tooltip text.");
+    }
+
+    QApplication::processEvents();
+
+    // QTest cannot simulate enter and leave events, hence send them directly.
+    // Each tooltip has to sit out its wait period and fade in completely
+    // before the pointer leaves, so that showing and hiding is measured too.
+    const auto items = window->labelMenu()->findChildren<priv::WindowItem*>();
+    int expected = 0;
+    int shown = 0;
+
+    for (int i = 0; i < 2; i++)
+    {
+        for (auto* item : items)
+        {
+            const QPoint center = item->rect().center();
+            QEnterEvent enter(center, item->mapTo(item->window(), center), item->mapToGlobal(center));
+            QEvent leave(QEvent::Leave);
+
+            QApplication::sendEvent(item, &enter);
+            expected++;
+
+            const bool faded = QTest::qWaitFor([]()
+                {
+                    OfficeTooltip* tooltip = findTooltip();
+                    return tooltip != nullptr &&
+                           tooltip->isVisible() &&
+                           tooltip->property("Opacity").toReal() >= 1.0;
+                }, 3000);
+
+            if (faded)
+            {
+                shown++;
+            }
+
+            QApplication::sendEvent(item, &leave);
+            QTest::qWaitFor([]()
+                {
+                    OfficeTooltip* tooltip = findTooltip();
+                    return tooltip == nullptr || !tooltip->isVisible();
+                }, 1000);
+        }
+    }
+
+    g_metrics["tooltipsExpected"] = expected;
+    g_metrics["tooltipsShown"] = shown;
+
+    if (shown != expected)
+    {
+        qWarning("tooltip_storm: only %d of %d tooltips were shown", shown, expected);
+    }
+}
+
+static void lineEditTyping(int coalescePeriod)
+{
+    QScopedPointer<OfficeWindow> window(createWindow());
+    OfficeLineEdit* edit = new OfficeLineEdit(window.data());
+    window->layout()->addWidget(edit);
+    edit->setCoalescePeriod(coalescePeriod);
+    edit->setFocus();
+
+    QApplication::processEvents();
+
+    // Types in chunks so that repaints can happen in between, like they do
+    // when a user is typing.
+    const QString chunk = QString("The quick brown fox jumps over the lazy dog. ").repeated(2).left(100);
+    for (int i = 0; i < 100; i++)
+    {
+        QTest::keyClicks(edit, chunk);
+        QApplication::processEvents();
+    }
+
+    // Waits for the last coalesced change to be reported.
+    QTest::qWait(coalescePeriod);
+}
+
+int main(int argc, char* argv[])
+{
+    // Runs without a display unless another platform is requested explicitly.
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+    {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QApplication app(argc, argv);
+    PaintCounter paintCounter;
+    app.installEventFilter(&paintCounter);
+
+    const Scenario scenarios[] =
+    {
+        { "window_resize_sweep",        windowResizeSweep                },
+        { "window_maximize_toggle",     windowMaximizeToggle             },
+        { "menu_expand_collapse",       menuExpandCollapse               },
+        { "menu_build_10k",             menuBuild10k                     },
+        { "menu_load_10k",              menuLoad10k                      },
+        { "menu_lazy_build",            menuLazyBuild                    },
+        { "menu_batch_rebuild",         menuBatchRebuild                 },
+        { "panel_bar_repaint",          [] { panelBarRepaint(false); }   },
+        { "panel_bar_repaint_effect",   [] { panelBarRepaint(true); }    },
+        { "panel_bar_adaptive_resize",  panelBarAdaptiveResize           },
+        { "menu_event_broadcast",       [] { menuEventDispatch(false); } },
+        { "menu_event_routed",          [] { menuEventDispatch(true); }  },
+        { "menu_event_queued",          menuEventQueued                  },
+        { "menu_command_executor",      menuCommandExecutor              },
+        { "menu_search_50k",            menuSearch50k                    },
+        { "menu_focus_churn",           menuFocusChurn                   },
+        { "menu_gallery_10",            [] { menuGalleryScroll(10); }    },
+        { "menu_gallery_10k",           [] { menuGalleryScroll(10000); } },
+        { "menu_dropdown_100k",         menuDropdown100k                 },
+        { "menu_font_picker_1k",        menuFontPicker1k                 },
+        { "tooltip_storm",              tooltipStorm                     },
+        { "line_edit_typing",           [] { lineEditTyping(0); }        },
+        { "line_edit_typing_coalesced", [] { lineEditTyping(50); }       }
+    };
+
+    QJsonArray results;
+    for (const auto& scenario : scenarios)
+    {
+        QElapsedTimer timer;
+        paintCounter.count = 0;
+        g_metrics = QJsonObject();
+
+        const quint64 allocations = g_allocations.load();
+        timer.start();
+        scenario.run();
+        QApplication::processEvents();
+
+        QJsonObject result;
+        result["name"] = scenario.name;
+        result["wallMs"] = timer.nsecsElapsed() / 1000000.0;
+        result["paints"] = static_cast<qint64>(paintCounter.count);
+        result["allocations"] = static_cast<qint64>(g_allocations.load() - allocations);
+
+        for (auto it = g_metrics.constBegin(); it != g_metrics.constEnd(); ++it)
+        {
+            result.insert(it.key(), it.value());
+        }
+
+        results.append(result);
+    }
+
+    QJsonObject report;
+    report["platform"] = QApplication::platformName();
+    report["qt"] = qVersion();
+    report["scenarios"] = results;
+
+    const QByteArray json = QJsonDocument(report).toJson();
+    if (argc > 1)
+    {
+        // Writes the report to the given file instead of the standard output.
+        QFile file(argv[1]);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        {
+            return 1;
+        }
+
+        file.write(json);
+    }
+    else
+    {
+        QTextStream(stdout) << json;
+    }
+
+    return 0;
+}
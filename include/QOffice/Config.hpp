@@ -138,6 +138,47 @@ inline QString QOfficeGetClass(const QString& func)
 
 #define OffCurrentClass QOfficeGetClass(OffCurrentFunc)
 
+#if defined(QOFFICE_ENABLE_TRACING)
+    QOFFICE_DESIGN_API qint64 QOfficeTraceNow();
+    QOFFICE_DESIGN_API void QOfficeTraceRecord(const char* name, qint64 begin, qint64 end);
+    QOFFICE_DESIGN_API bool QOfficeTraceDump(const QString& path);
+
+    // Measures the lifetime of the enclosing scope. The name must be a string
+    // literal, since only the pointer is stored in the trace buffer.
+    class QOfficeTraceScope
+    {
+    public:
+
+        explicit QOfficeTraceScope(const char* name)
+            : m_name(name)
+            , m_begin(QOfficeTraceNow())
+        {
+        }
+
+        ~QOfficeTraceScope()
+        {
+            QOfficeTraceRecord(m_name, m_begin, QOfficeTraceNow());
+        }
+
+        OffDisableCopy(QOfficeTraceScope)
+        OffDisableMove(QOfficeTraceScope)
+
+    private:
+
+        const char* m_name;
+        qint64      m_begin;
+    };
+
+    #define OffTraceJoinImpl(a,b) a##b
+    #define OffTraceJoin(a,b) OffTraceJoinImpl(a,b)
+    #define OffTraceScope(name) QOfficeTraceScope OffTraceJoin(qofficeTraceScope, __LINE__)(name)
+    #define OffTraceDump(path) QOfficeTraceDump(path)
+#else
+    // Tracing is compiled out entirely; not even the name is evaluated.
+    #define OffTraceScope(name)
+    #define OffTraceDump(path) false
+#endif
+
 #endif
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -192,6 +233,15 @@ inline QString QOfficeGetClass(const QString& func)
 /// \def OffCurrentClass
 /// Retrieves the beautified name of the current class.
 ///
+/// \def OffTraceScope
+/// Records the duration of the enclosing scope under the given string literal.
+/// Expands to nothing unless QOFFICE_ENABLE_TRACING is defined.
+///
+/// \def OffTraceDump
+/// Writes all recorded trace events to the given file in the Chrome trace
+/// event format, which can be loaded into chrome://tracing or Perfetto.
+/// Evaluates to false unless QOFFICE_ENABLE_TRACING is defined.
+///
 ////////////////////////////////////////////////////////////////////////////////
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -91,6 +91,17 @@ public:
     ///
     ////////////////////////////////////////////////////////////////////////////
     static QPixmap generateDropShadow(const QSize& size);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Generates a drop shadow of the given \p size without relying on the
+    /// graphics view framework. Unlike OfficeImage::generateDropShadow, this
+    /// function may be called from any thread.
+    ///
+    /// \param[in] size The size of the drop shadow.
+    /// \return The image containing the shadow.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    static QImage generateDropShadowImage(const QSize& size);
 };
 
 #endif
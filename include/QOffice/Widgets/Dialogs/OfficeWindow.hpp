@@ -280,14 +280,26 @@ protected:
     virtual void focusInEvent(QFocusEvent*) override;
     virtual void focusOutEvent(QFocusEvent*) override;
     virtual void showEvent(QShowEvent*) override;
+    virtual void changeEvent(QEvent*) override;
     virtual bool event(QEvent*) override;
 
 private:
 
+    struct ChromeLayout
+    {
+        QSize    size;
+        QRect    clientRectangle;
+        QRect    titleRectangle;
+        QMargins layoutMargins;
+    };
+
     void generateDropShadow();
-    void updateResizeRectangles();
+    void updateChrome();
     void updateResizeWidgets();
-    void updateLayoutPadding();
+    void prepareChromeLayouts();
+    void prepareChromeLayout(priv::Titlebar::LayoutMode mode, const QSize& size);
+    void applyChromeLayout(priv::Titlebar::LayoutMode mode);
+    priv::Titlebar::LayoutMode chromeMode() const;
 
     priv::ResizeArea* m_resizeTopLeft;
     priv::ResizeArea* m_resizeTopRight;
@@ -302,6 +314,7 @@ private:
     Flags             m_flagsWindow;
     QPixmap           m_dropShadow;
     QRect             m_clientRectangle;
+    ChromeLayout      m_chromeLayouts[priv::Titlebar::LayoutModeCount];
     bool              m_tooltipVisible;
 
     Q_OBJECT
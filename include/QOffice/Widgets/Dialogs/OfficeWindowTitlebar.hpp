@@ -28,6 +28,8 @@
 #include <QWidget>
 
 class OfficeWindow;
+class QPainter;
+class TestTitlebar;
 
 namespace priv
 {
@@ -41,7 +43,34 @@ public:
         ButtonNone,
         ButtonHover,
         ButtonPress,
-        ButtonSpecial
+        ButtonSpecial,
+        ButtonStateCount
+    };
+
+    enum Button
+    {
+        NoButton = -1,
+        CloseButton,
+        MaximizeButton,
+        MinimizeButton,
+        ButtonCount
+    };
+
+    enum ButtonEvent
+    {
+        EventMove,
+        EventCapturedMove,
+        EventPress,
+        EventRelease,
+        EventLeave,
+        ButtonEventCount
+    };
+
+    enum LayoutMode
+    {
+        NormalLayout,
+        MaximizedLayout,
+        LayoutModeCount
     };
 
     OffDefaultDtor(Titlebar)
@@ -58,41 +87,73 @@ protected:
     void mouseReleaseEvent(QMouseEvent*) override;
     void mouseDoubleClickEvent(QMouseEvent*) override;
     void leaveEvent(QEvent*) override;
+    void changeEvent(QEvent*) override;
 
 private:
 
-    void updateRectangles();
-    void updateVisibleTitle();
+    struct LayerKey
+    {
+        QRgb    accent;
+        int     flags;
+        bool    active;
+        bool    maximized;
+        qreal   ratio;
+        QSize   size;
+        QString title;
+
+        bool operator ==(const LayerKey& other) const;
+    };
+
+    struct Layout
+    {
+        QSize   size;
+        int     flags;
+        int     menuWidth;
+        QString title;
+        QRect   buttonRectangles[ButtonCount];
+        QRect   buttonArea;
+        QRect   dragRectangle;
+        QRect   titleRectangle;
+        QString visibleTitle;
+    };
+
+    bool prepareLayout(LayoutMode mode, const QSize& size);
+    void applyLayout(LayoutMode mode);
+    void updateRectangles(Layout& layout) const;
+    void updateVisibleTitle(Layout& layout) const;
+    void toggleMaximized();
+    void updateStaticLayer();
+    void resetButtons();
+    void paintButton(QPainter&, Button);
+    bool isButtonVisible(Button) const;
+    bool isButtonCaptured() const;
+    Button hitTest(const QPoint&) const;
+    QRegion transition(ButtonEvent, const QPoint&, Button* triggered = nullptr);
     bool mouseMoveDrag(const QPoint&);
-    bool mouseMoveSpecial(const QPoint&);
-    bool mouseMoveHitTest(const QPoint&);
     bool mousePressDrag(const QPoint&);
-    bool mousePressHitTest(const QPoint&);
     bool mouseReleaseDrag(const QPoint&);
-    bool mouseReleaseAction(const QPoint&);
-    QRect centerRectangle(const QPixmap&, const QRect&);
+    void mouseReleaseAction(Button);
+    const QPixmap& buttonImage(Button) const;
+    QRect centerRectangle(const QPixmap&, const QRect&) const;
 
     OfficeWindow*     m_window;
     OfficeWindowMenu* m_windowLabelMenu;
     OfficeWindowMenu* m_windowQuickMenu;
-    ButtonState       m_stateClose;
-    ButtonState       m_stateMaximize;
-    ButtonState       m_stateMinimize;
+    ButtonState       m_buttonStates[ButtonCount];
     QPixmap           m_imageClose;
     QPixmap           m_imageMaximize;
     QPixmap           m_imageMinimize;
     QPixmap           m_imageRestore;
-    QString           m_visibleTitle;
+    QPixmap           m_staticLayer;
+    LayerKey          m_layerKey;
+    Layout            m_layouts[LayoutModeCount];
+    const Layout*     m_layout;
     QPoint            m_dragPosition;
-    QRect             m_titleRectangle;
-    QRect             m_dragRectangle;
-    QRect             m_closeRectangle;
-    QRect             m_maximizeRectangle;
-    QRect             m_minimizeRectangle;
 
     friend class ::OfficeWindow;
     friend class ::OfficeWindowMenu;
     friend class priv::ResizeArea;
+    friend class ::TestTitlebar;
 };
 }
 
@@ -0,0 +1,292 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// QOffice - The office framework for Qt
+// Copyright (C) 2016-2018 Nicolas Kogler
+//
+// This file is part of the Widget module.
+//
+// QOffice is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// QOffice is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with QOffice. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#ifndef QOFFICE_WIDGETS_MENUITEMS_OFFICEMENUDROPDOWNITEM_HPP
+#define QOFFICE_WIDGETS_MENUITEMS_OFFICEMENUDROPDOWNITEM_HPP
+
+#include <QOffice/Widgets/OfficeMenuEvent.hpp>
+#include <QOffice/Widgets/OfficeMenuItem.hpp>
+#include <QElapsedTimer>
+#include <QListView>
+#include <QPersistentModelIndex>
+#include <QVector>
+#include <QWidget>
+
+class QAbstractItemModel;
+class QStringListModel;
+class OfficeMenuDropdownItem;
+
+namespace priv
+{
+// Maps case-folded prefixes to the rows of a model. Built on the first
+// lookup after the model changed; a lookup is a binary search.
+class PrefixIndex
+{
+public:
+
+    OffDeclareCtor(PrefixIndex)
+    OffDefaultDtor(PrefixIndex)
+    OffDisableCopy(PrefixIndex)
+    OffDisableMove(PrefixIndex)
+
+    void invalidate();
+    int find(const QAbstractItemModel* model, const QString& prefix);
+
+private:
+
+    struct Entry
+    {
+        QString key;
+        int     row;
+    };
+
+    QVector<Entry> m_entries;
+    bool           m_isValid;
+};
+
+// Lists the entries of a drop-down and forwards type-ahead to its index.
+class DropdownView : public QListView
+{
+public:
+
+    OffDefaultDtor(DropdownView)
+    OffDisableCopy(DropdownView)
+    OffDisableMove(DropdownView)
+
+    DropdownView(QWidget* parent, OfficeMenuDropdownItem* item);
+
+    void keyboardSearch(const QString& search) override;
+
+protected:
+
+    void keyPressEvent(QKeyEvent*) override;
+
+private:
+
+    OfficeMenuDropdownItem* m_item;
+};
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class OfficeMenuDropdownItem
+/// \ingroup Widget
+///
+/// \brief Defines a drop-down list on the menu.
+///
+/// The drop-down displays the first column of a QAbstractItemModel. Its popup
+/// is a list of uniformly sized rows, hence opening it costs the same for ten
+/// entries as for a hundred thousand; only the visible rows are ever measured
+/// and painted. Choosing an entry emits an OfficeMenuEvent::ItemChanged event:
+///
+/// \code
+/// auto* sizes = new OfficeMenuDropdownItem({ "8", "9", "10", "11", "12" });
+/// panel->insertItem(c_fontSize, sizes, 0, 1);
+///
+/// QObject::connect(officeMenu, &OfficeMenu::itemChangedEvent,
+///     [] (OfficeMenuItemChangedEvent* event)
+///         {
+///             qDebug() << event->index() << event->text();
+///         }
+///     );
+/// \endcode
+///
+/// Typing while the drop-down or its popup has the focus jumps to the first
+/// entry, in alphabetical order, that starts with the typed text. The lookup
+/// uses a sorted prefix index that is built once after each model change.
+///
+/// The chosen entry is tracked through model changes, even if rows above it
+/// are inserted or removed. If the entry itself is removed, an
+/// OfficeMenuEvent::ItemChanged event with the index -1 is emitted.
+///
+////////////////////////////////////////////////////////////////////////////////
+class QOFFICE_WIDGET_API OfficeMenuDropdownItem
+    : public QWidget
+    , public OfficeMenuItem
+{
+public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Defines the model roles the drop-down reads in addition to
+    ///        Qt::DisplayRole.
+    /// \enum Role
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    enum Role
+    {
+        ValueRole = Qt::UserRole ///< The underlying value of a row.
+    };
+
+    OffDefaultDtor(OfficeMenuDropdownItem)
+    OffDisableCopy(OfficeMenuDropdownItem)
+    OffDisableMove(OfficeMenuDropdownItem)
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Initializes a new instance of OfficeMenuDropdownItem with the given
+    /// \p items.
+    ///
+    /// \param[in] items The entries of the drop-down.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    OfficeMenuDropdownItem(const QStringList& items = QStringList());
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Initializes a new instance of OfficeMenuDropdownItem that displays the
+    /// given \p model. The model is not owned by the drop-down.
+    ///
+    /// \param[in] model The model to display.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    OfficeMenuDropdownItem(QAbstractItemModel* model);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the model this drop-down displays.
+    ///
+    /// \return The model of this drop-down.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    QAbstractItemModel* model() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the row of the chosen entry.
+    ///
+    /// \return The chosen row, or -1 if none is chosen.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int currentIndex() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the text of the chosen entry.
+    ///
+    /// \return The chosen text, or an empty string if none is chosen.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    QString currentText() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the maximum amount of rows the popup shows at once.
+    ///
+    /// \return The maximum amount of visible rows.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int maxVisibleItems() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Replaces the entries of this drop-down with the given \p items.
+    ///
+    /// \param[in] items The new entries.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setItems(const QStringList& items);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the model this drop-down displays. The model is not owned by
+    /// the drop-down.
+    ///
+    /// \param[in] model The new model.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setModel(QAbstractItemModel* model);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Chooses the entry in the given \p row without emitting an event.
+    ///
+    /// \param[in] row The row to choose, or -1 to choose none.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setCurrentIndex(int row);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the maximum amount of rows the popup shows at once. The
+    /// default is 20.
+    ///
+    /// \param[in] count The new maximum amount of visible rows.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setMaxVisibleItems(int count);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Shows the popup below the drop-down.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void showPopup();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Hides the popup.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void hidePopup();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the desired size for this widget.
+    ///
+    /// \return The desired width and height, in pixels.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    QSize sizeHint() const override;
+
+    QWidget* widget() override;
+
+protected:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the list that displays the entries within the popup, e.g. in
+    /// order to specify a custom delegate.
+    ///
+    /// \return The list of the popup.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    QListView* popupView() const;
+
+    virtual void paintEvent(QPaintEvent*) override;
+    virtual void keyPressEvent(QKeyEvent*) override;
+    virtual void mousePressEvent(QMouseEvent*) override;
+    virtual void wheelEvent(QWheelEvent*) override;
+
+private slots:
+
+    void onClicked(const QModelIndex&);
+    void onModelChanged();
+
+private:
+
+    void typeAhead(const QString&);
+    void choose(int);
+    void init();
+
+    QStringListModel*     m_items;
+    QAbstractItemModel*   m_model;
+    QWidget*              m_popup;
+    priv::DropdownView*   m_view;
+    priv::PrefixIndex     m_index;
+    QElapsedTimer         m_typeAheadTimer;
+    QString               m_typeAhead;
+    QPersistentModelIndex m_current;
+    int                   m_maxVisibleItems;
+    bool                  m_hasCurrent;
+
+    Q_OBJECT
+
+    friend class priv::DropdownView;
+};
+
+#endif
@@ -0,0 +1,137 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// QOffice - The office framework for Qt
+// Copyright (C) 2016-2018 Nicolas Kogler
+//
+// This file is part of the Widget module.
+//
+// QOffice is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// QOffice is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with QOffice. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#ifndef QOFFICE_WIDGETS_MENUITEMS_OFFICEMENUFONTPICKERITEM_HPP
+#define QOFFICE_WIDGETS_MENUITEMS_OFFICEMENUFONTPICKERITEM_HPP
+
+#include <QOffice/Widgets/MenuItems/OfficeMenuDropdownItem.hpp>
+#include <QFont>
+
+namespace priv { class FontPreviewDelegate; }
+namespace priv { class ThumbnailCache; }
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class OfficeMenuFontPickerItem
+/// \ingroup Widget
+///
+/// \brief Defines a drop-down list of font families on the menu.
+///
+/// Each family in the popup is previewed in its own face. Loading a font face
+/// is expensive, hence the previews are rendered on a worker thread once their
+/// row scrolls into view for the first time; until then, the row shows the
+/// family name in the regular UI font. Rendered previews are kept across
+/// openings of the popup. Choosing a family emits an
+/// OfficeMenuEvent::ItemChanged event whose text is the family name:
+///
+/// \code
+/// auto* fonts = new OfficeMenuFontPickerItem;
+/// fonts->setCurrentFont(QFont("Open Sans"));
+/// panel->insertItem(c_fontFamily, fonts, 0, 0);
+/// \endcode
+///
+/// \remarks Previews are only rendered if the platform supports rendering
+///          fonts outside the GUI thread, see
+///          QFontDatabase::supportsThreadedFontRendering.
+///
+////////////////////////////////////////////////////////////////////////////////
+class QOFFICE_WIDGET_API OfficeMenuFontPickerItem : public OfficeMenuDropdownItem
+{
+public:
+
+    OffDefaultDtor(OfficeMenuFontPickerItem)
+    OffDisableCopy(OfficeMenuFontPickerItem)
+    OffDisableMove(OfficeMenuFontPickerItem)
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Initializes a new instance of OfficeMenuFontPickerItem that lists all
+    /// font families installed on the system.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    OfficeMenuFontPickerItem();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Initializes a new instance of OfficeMenuFontPickerItem that lists the
+    /// given font \p families.
+    ///
+    /// \param[in] families The font families to list.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    OfficeMenuFontPickerItem(const QStringList& families);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the font of the chosen family.
+    ///
+    /// \return The chosen font, or the default font if none is chosen.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    QFont currentFont() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Chooses the family of the given \p font without emitting an event.
+    ///
+    /// \param[in] font The font whose family to choose.
+    /// \return True if the family is listed, false otherwise.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool setCurrentFont(const QFont& font);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the maximum amount of previews that are kept in memory.
+    ///
+    /// \return The maximum amount of cached previews.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int previewCapacity() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the maximum amount of previews that are kept in memory. The
+    /// least recently painted previews are dropped first. The default is 512.
+    ///
+    /// \param[in] capacity The new maximum amount of cached previews.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setPreviewCapacity(int capacity);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the desired size for this widget.
+    ///
+    /// \return The desired width and height, in pixels.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    QSize sizeHint() const override;
+
+private slots:
+
+    void onPreviewReady();
+
+private:
+
+    void init();
+
+    priv::ThumbnailCache*      m_previews;
+    priv::FontPreviewDelegate* m_delegate;
+
+    Q_OBJECT
+};
+
+#endif
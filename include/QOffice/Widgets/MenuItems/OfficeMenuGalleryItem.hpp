@@ -0,0 +1,223 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// QOffice - The office framework for Qt
+// Copyright (C) 2016-2018 Nicolas Kogler
+//
+// This file is part of the Widget module.
+//
+// QOffice is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// QOffice is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with QOffice. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#ifndef QOFFICE_WIDGETS_MENUITEMS_OFFICEMENUGALLERYITEM_HPP
+#define QOFFICE_WIDGETS_MENUITEMS_OFFICEMENUGALLERYITEM_HPP
+
+#include <QOffice/Widgets/MenuItems/OfficeMenuThumbnailCache.hpp>
+#include <QOffice/Widgets/OfficeMenuEvent.hpp>
+#include <QOffice/Widgets/OfficeMenuItem.hpp>
+#include <QWidget>
+
+class QAbstractItemModel;
+class QListView;
+class QModelIndex;
+class QToolButton;
+
+namespace priv { class GalleryDelegate; }
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class OfficeMenuGalleryItem
+/// \ingroup Widget
+///
+/// \brief Defines a gallery of thumbnails on the menu.
+///
+/// The gallery displays the rows of a QAbstractItemModel as a grid of cells of
+/// uniform size. Only the visible cells are ever painted; the arrow next to the
+/// gallery shows more of them in a scrollable popup. Each cell displays the
+/// Qt::DecorationRole of its row, if any, and its Qt::DisplayRole below:
+///
+/// \code
+/// auto* model = new QStandardItemModel;
+/// for (const auto& path : stylePreviews)
+/// {
+///     auto* row = new QStandardItem(QFileInfo(path).baseName());
+///     row->setData(path, OfficeMenuGalleryItem::ThumbnailRole);
+///     model->appendRow(row);
+/// }
+///
+/// panel->insertItem(c_styles, new OfficeMenuGalleryItem(model), 0, 0, 3, 1);
+/// \endcode
+///
+/// Rows without decoration provide a key through OfficeMenuGalleryItem::
+/// ThumbnailRole instead. The thumbnail of such a row is loaded on a worker
+/// thread the first time its cell becomes visible and is kept in a cache of
+/// the most recently used thumbnails; loads of cells that are scrolled away
+/// before their thumbnail is ready are cancelled. By default, the key is the path of an
+/// image file; see OfficeMenuGalleryItem::setThumbnailLoader.
+///
+/// Selecting a cell emits an OfficeMenuEvent::ItemChanged event that carries
+/// the row, the Qt::DisplayRole and the OfficeMenuGalleryItem::ValueRole of
+/// the selected row.
+///
+////////////////////////////////////////////////////////////////////////////////
+class QOFFICE_WIDGET_API OfficeMenuGalleryItem
+    : public QWidget
+    , public OfficeMenuItem
+{
+public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Defines the model roles the gallery reads.
+    /// \enum Role
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    enum Role
+    {
+        ValueRole = Qt::UserRole,        ///< The underlying value of a row.
+        ThumbnailRole = Qt::UserRole + 1 ///< The key of a row's thumbnail.
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Renders a thumbnail of the given size from its key. Called on a
+    ///        worker thread.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    typedef priv::ThumbnailCache::Loader ThumbnailLoader;
+
+    OffDefaultDtor(OfficeMenuGalleryItem)
+    OffDisableCopy(OfficeMenuGalleryItem)
+    OffDisableMove(OfficeMenuGalleryItem)
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Initializes a new instance of OfficeMenuGalleryItem that displays the
+    /// given \p model. The model is not owned by the gallery.
+    ///
+    /// \param[in] model The model to display, or nullptr.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    OfficeMenuGalleryItem(QAbstractItemModel* model = nullptr);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the model this gallery displays.
+    ///
+    /// \return The model of this gallery.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    QAbstractItemModel* model() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the size of the thumbnails, in pixels.
+    ///
+    /// \return The thumbnail size.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    QSize thumbnailSize() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the maximum amount of cached thumbnails.
+    ///
+    /// \return The cache capacity.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int cacheCapacity() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the row of the selected cell.
+    ///
+    /// \return The selected row, or -1 if none is selected.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int currentRow() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the model this gallery displays. The model is not owned by
+    /// the gallery.
+    ///
+    /// \param[in] model The new model, or nullptr.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setModel(QAbstractItemModel* model);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the size of the thumbnails. Discards all cached thumbnails.
+    ///
+    /// \param[in] size The new thumbnail size, in pixels.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setThumbnailSize(const QSize& size);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the maximum amount of cached thumbnails. The least recently
+    /// used thumbnails are discarded first. The default capacity is 256.
+    ///
+    /// \param[in] capacity The new cache capacity.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setCacheCapacity(int capacity);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the function that renders the thumbnail of a key provided
+    /// through OfficeMenuGalleryItem::ThumbnailRole. Discards all cached
+    /// thumbnails.
+    ///
+    /// \param[in] loader The new thumbnail loader.
+    ///
+    /// \remarks The loader runs on a worker thread and must therefore neither
+    ///          access the model nor create any QPixmap.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setThumbnailLoader(ThumbnailLoader loader);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Selects the cell of the given \p row without emitting an event.
+    ///
+    /// \param[in] row The row to select, or -1 to clear the selection.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setCurrentRow(int row);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Shows all cells in a scrollable popup below the gallery.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void showPopup();
+
+    QWidget* widget() override;
+
+protected:
+
+    bool eventFilter(QObject*, QEvent*) override;
+
+private slots:
+
+    void onCurrentChanged(const QModelIndex&, const QModelIndex&);
+    void onThumbnailReady();
+
+private:
+
+    void updateCellSize();
+    void retainVisibleThumbnails();
+
+    priv::ThumbnailCache*  m_cache;
+    priv::GalleryDelegate* m_delegate;
+    QListView*             m_view;
+    QListView*             m_popupView;
+    QWidget*               m_popup;
+    QToolButton*           m_popupButton;
+    bool                   m_isSelecting;
+
+    Q_OBJECT
+};
+
+#endif
@@ -48,6 +48,10 @@
 ///     );
 /// \endcode
 ///
+/// Additionally, an OfficeMenuEvent::TextEdited event that only contains the
+/// edited part of the text is emitted for every change. Use
+/// OfficeLineEdit::setCoalescePeriod to report bursts of keystrokes as one.
+///
 ////////////////////////////////////////////////////////////////////////////////
 class QOFFICE_WIDGET_API OfficeMenuTextboxItem
     : public OfficeLineEdit
@@ -73,6 +77,7 @@ public:
 private slots:
 
     void onTextChanged(QString, QString);
+    void onTextEdited(int, int, const QString&);
 };
 
 #endif
@@ -0,0 +1,103 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// QOffice - The office framework for Qt
+// Copyright (C) 2016-2018 Nicolas Kogler
+//
+// This file is part of the Widget module.
+//
+// QOffice is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// QOffice is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with QOffice. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#ifndef QOFFICE_WIDGETS_MENUITEMS_OFFICEMENUTHUMBNAILCACHE_HPP
+#define QOFFICE_WIDGETS_MENUITEMS_OFFICEMENUTHUMBNAILCACHE_HPP
+
+#include <QOffice/Config.hpp>
+#include <QAtomicInt>
+#include <QCache>
+#include <QHash>
+#include <QImage>
+#include <QObject>
+#include <QPixmap>
+#include <QSet>
+#include <QSharedPointer>
+#include <QThreadPool>
+#include <functional>
+
+namespace priv
+{
+// Renders thumbnails on a worker thread and keeps the most recently used ones.
+// Views request thumbnails while painting, draw a placeholder until they are
+// ready and repaint once ThumbnailCache::thumbnailReady is emitted. The loader
+// runs on the worker thread and may therefore not create any QPixmap.
+//
+// Loads that are no longer wanted are cancelled through ThumbnailCache::retain,
+// which views call with the keys of their visible cells. A cancelled load does
+// not run the loader and its result, if any, never enters the cache.
+class ThumbnailCache : public QObject
+{
+public:
+
+    typedef std::function<QImage(const QString&, const QSize&)> Loader;
+
+    OffDeclareDtor(ThumbnailCache)
+    OffDisableCopy(ThumbnailCache)
+    OffDisableMove(ThumbnailCache)
+
+    ThumbnailCache(QObject* parent, Loader loader);
+
+    int capacity() const;
+    const QSize& size() const;
+
+    void setCapacity(int capacity);
+    void setSize(const QSize& size);
+    void setLoader(Loader loader);
+
+    bool hasPending() const;
+    const QPixmap* find(const QString& key);
+    void request(const QString& key);
+    void retain(const QSet<QString>& keys);
+    void clear();
+
+signals:
+
+    void thumbnailReady(const QString& key);
+
+private:
+
+    typedef QSharedPointer<QAtomicInt> Ticket;
+
+    struct Pending
+    {
+        Ticket ticket;
+        int    priority;
+    };
+
+    QHash<QString, Pending>::iterator cancel(QHash<QString, Pending>::iterator);
+    void insert(const Ticket&, const QString&, const QImage&);
+
+    QThreadPool               m_pool;
+    QCache<QString, QPixmap>  m_cache;
+    QHash<QString, Pending>   m_pending;
+    Loader                    m_loader;
+    QSize                     m_size;
+    int                       m_pendingLimit;
+    int                       m_nextPriority;
+
+    Q_OBJECT
+};
+}
+
+#endif
@@ -27,6 +27,8 @@
 #include <QOffice/Config.hpp>
 #include <QLineEdit>
 
+class QTimer;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// \class OfficeLineEdit
 /// \ingroup Widget
@@ -44,6 +46,14 @@
 /// m_officeLineEdit->setFormat(OfficeLineEdit::HexOnly);
 /// \endcode
 ///
+/// By default, the change signals are emitted for every keystroke. Handlers
+/// that perform expensive work (e.g. searches) may instead want to receive a
+/// single change once the user stopped typing:
+///
+/// \code
+/// m_officeLineEdit->setCoalescePeriod(250); // in msec
+/// \endcode
+///
 ////////////////////////////////////////////////////////////////////////////////
 class QOFFICE_WIDGET_API OfficeLineEdit : public QLineEdit
 {
@@ -95,6 +105,24 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     void setFormat(Format format);
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the quiet period after which changes are reported.
+    ///
+    /// \return The coalesce period, in milliseconds. Zero if disabled.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int coalescePeriod() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the quiet period after which changes are reported. All
+    /// changes within the period are combined into a single change. Pending
+    /// changes are reported immediately once editing finishes.
+    ///
+    /// \param[in] milliseconds The new coalesce period. Zero disables it.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setCoalescePeriod(int milliseconds);
+
 signals:
 
     ////////////////////////////////////////////////////////////////////////////
@@ -106,6 +134,17 @@ signals:
     ////////////////////////////////////////////////////////////////////////////
     void contentChanged(QString previous, QString current);
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Is emitted right before OfficeLineEdit::contentChanged and describes the
+    /// change as a single edit, without copying the entire text.
+    ///
+    /// \param[in] position The position of the first changed character.
+    /// \param[in] removed The amount of characters removed at \p position.
+    /// \param[in] inserted The text inserted at \p position.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void contentEdited(int position, int removed, const QString& inserted);
+
 protected:
 
     virtual void keyPressEvent(QKeyEvent*) override; // check format rules.
@@ -113,11 +152,13 @@ protected:
 private slots:
 
      void generateEvent();
+     void flushEvent();
 
 private:
 
     Format m_format;    ///< Defines the format of this textbox.
     QString m_previous; ///< Defines the previous text.
+    QTimer* m_timer;    ///< Reports coalesced changes after the quiet period.
     bool m_hasTyped;    ///< Determines whether the user has typed anything.
 
     Q_OBJECT
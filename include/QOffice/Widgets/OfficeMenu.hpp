@@ -24,16 +24,26 @@
 #ifndef QOFFICE_WIDGET_OFFICEMENU_HPP
 #define QOFFICE_WIDGET_OFFICEMENU_HPP
 
+#include <QOffice/Widgets/OfficeMenuEvent.hpp>
+#include <QOffice/Widgets/OfficeMenuEventHandle.hpp>
+#include <QOffice/Widgets/OfficeMenuSearchIndex.hpp>
 #include <QOffice/Widgets/OfficeWidget.hpp>
+#include <QHash>
+#include <QPointer>
+#include <QSet>
+#include <QVector>
 #include <QWidget>
+#include <functional>
 
-class OfficeMenuEvent;
 class OfficeMenuTextChangedEvent;
+class OfficeMenuTextEditedEvent;
 class OfficeMenuButtonClickedEvent;
 class OfficeMenuItemChangedEvent;
 class OfficeMenuHeader;
 class OfficeMenuItem;
+class OfficeMenuPanel;
 class QHBoxLayout;
+class QLayout;
 
 namespace priv { class PinButton; }
 
@@ -50,7 +60,13 @@ class QOFFICE_WIDGET_API OfficeMenu : public QWidget, public OfficeWidget
 {
 public:
 
-    OffDefaultDtor(OfficeMenu)
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Handles an event of a single menu item.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    typedef std::function<void(OfficeMenuEvent*)> EventHandler;
+
+    OffDeclareDtor(OfficeMenu)
     OffDisableCopy(OfficeMenu)
     OffDisableMove(OfficeMenu)
 
@@ -77,9 +93,9 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     /// Retrieves a pointer to the item with the given \p itemId. If one of
     /// \p headerId or \p panelId is -1, the item with the given ID will be
-    /// searched dynamically. Note that this can add a significant overhead and
-    /// might not even be accurate, since item IDs can theoretically be
-    /// identical across different panels and headers.
+    /// looked up in a menu-wide index. Note that this might not be accurate,
+    /// since item IDs can theoretically be identical across different panels
+    /// and headers; the most recently inserted item wins in that case.
     ///
     /// \remarks This is equivalent to calling
     ///          menu->headerById(hid)->panelById(pid)->itemById(iid);
@@ -112,6 +128,15 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     bool isPinned() const;
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether a batch of changes started by OfficeMenu::beginUpdate
+    /// is in progress.
+    ///
+    /// \return True if updates are suspended, false otherwise.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool isUpdating() const;
+
     ////////////////////////////////////////////////////////////////////////////
     /// Specifies whether this menu should be pinned.
     ///
@@ -172,6 +197,99 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     void collapse();
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Materializes all headers that only hold declared panels, one header per
+    /// event loop iteration. Call this once the application is idle in order
+    /// to avoid the construction cost on the first expansion of a header.
+    ///
+    /// \remarks See OfficeMenuHeader::declarePanel.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void prebuild();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Starts a batch of changes. Until the matching call to
+    /// OfficeMenu::endUpdate, inserting or removing headers, panels and items
+    /// neither activates any layout nor repaints the menu or its popups. Calls
+    /// may be nested. Layouts that are disabled beforehand stay disabled.
+    ///
+    /// \code
+    /// menu->beginUpdate();
+    /// header->removePanel(1);
+    /// header->appendPanel(2, "Table")->insertItem(1, item, 0, 0);
+    /// menu->endUpdate();
+    /// \endcode
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void beginUpdate();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Ends a batch of changes. The outermost call lays out the menu once and
+    /// repaints it.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void endUpdate();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Subscribes the given \p handler to events of the given \p type that are
+    /// emitted by items with the given \p itemId. Unlike the signals of this
+    /// class, which reach every connected slot, an event is only dispatched to
+    /// the handlers that subscribed to its type and item.
+    ///
+    /// \code
+    /// menu->subscribe(c_fontSize, OfficeMenuEvent::TextChanged,
+    ///     [] (OfficeMenuEvent* event)
+    ///         {
+    ///             auto* textEvent = static_cast<OfficeMenuTextChangedEvent*>(event);
+    ///             qDebug() << textEvent->currentText();
+    ///         }
+    ///     );
+    /// \endcode
+    ///
+    /// \param[in] itemId The ID of the item whose events to handle.
+    /// \param[in] type The type of the events to handle.
+    /// \param[in] handler The handler to invoke.
+    /// \return A handle to pass to OfficeMenu::unsubscribe.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int subscribe(int itemId, OfficeMenuEvent::Type type, EventHandler handler);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Removes the subscription with the given \p handle. If called while an
+    /// event is dispatched, the handler is not invoked for that event anymore.
+    ///
+    /// \param[in] handle The handle returned by OfficeMenu::subscribe.
+    /// \return True if removed, false if the \p handle is invalid.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool unsubscribe(int handle);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Finds the headers, panels and items whose text matches the given
+    /// \p query. Items are found by their OfficeMenuItem::searchText.
+    ///
+    /// \param[in] query The text to search for.
+    /// \param[in] limit The maximum amount of matches to return.
+    /// \return The best matches, best first.
+    ///
+    /// \remarks Panels and items that are only declared, e.g. by a lazy
+    ///          ::OfficeMenuLoader, are not indexed and hence not found until
+    ///          their header is materialized; only the texts of headers are
+    ///          searchable right away. Call OfficeMenu::prebuild to materialize
+    ///          all headers in the background and make their contents
+    ///          searchable. See ::OfficeMenuSearchIndex.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    QVector<OfficeMenuSearchIndex::Match> search(const QString& query, int limit = 10);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Expands the header of the given \p match and focuses its item, if any.
+    ///
+    /// \param[in] match A match returned by OfficeMenu::search.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void reveal(const OfficeMenuSearchIndex::Match& match);
+
     ////////////////////////////////////////////////////////////////////////////
     /// Retrieves the desired size for this widget.
     ///
@@ -218,26 +336,72 @@ signals:
     ////////////////////////////////////////////////////////////////////////////
     void itemChangedEvent(OfficeMenuItemChangedEvent* event);
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// This signal is emitted along with OfficeMenu::textChangedEvent and only
+    /// describes the edited part of the text.
+    ///
+    /// \param[in] event Contains information about the edit.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void textEditedEvent(OfficeMenuTextEditedEvent* event);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// This signal is emitted for every event that an item emits as pooled
+    /// ::OfficeMenuEventHandle, after all the other signals. Unlike those, it
+    /// is safe to connect to receivers on other threads through queued
+    /// connections.
+    ///
+    /// \param[in] event Shares the event with all receivers.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void sharedItemEvent(OfficeMenuEventHandle event);
+
 protected:
 
     virtual void accentUpdateEvent() override;
     virtual void paintEvent(QPaintEvent*) override;
-    virtual void focusOutEvent(QFocusEvent*) override;
-    virtual bool eventFilter(QObject*, QEvent*) override;
+
+private slots:
+
+    void onFocusChanged(QWidget*, QWidget*);
 
 private:
 
-    void collapseOnFocusLost();
+    bool isOwned(const QWidget*) const;
+    void indexItem(OfficeMenuItem*);
+    void unindexItem(OfficeMenuItem*);
+    void unindexPanel(OfficeMenuPanel*);
+    void suspendLayout(QLayout*);
+    void dispatchEvent(OfficeMenuEvent*);
+
+    struct Subscription
+    {
+        int          handle;
+        EventHandler handler;
+    };
 
-    QList<OfficeMenuHeader*> m_headers;
-    QHBoxLayout*             m_headerLayout;
-    QHBoxLayout*             m_panelLayout;
-    bool                     m_isExpanded;
-    bool                     m_isPinned;
-    bool                     m_isTooltipShown;
+    QList<OfficeMenuHeader*>              m_headers;
+    QHash<int, OfficeMenuHeader*>         m_headerIndex;
+    QMultiHash<int, OfficeMenuItem*>      m_itemIndex;
+    QHash<quint64, QVector<Subscription>> m_subscriptions;
+    QHash<int, quint64>                   m_subscriptionKeys;
+    QSet<const QWidget*>                  m_ownedWidgets;
+    QVector<QPointer<QLayout>>            m_suspendedLayouts;
+    QVector<QPointer<QWidget>>            m_suspendedWindows;
+    OfficeMenuSearchIndex                 m_searchIndex;
+    QHBoxLayout*                          m_headerLayout;
+    QHBoxLayout*                          m_panelLayout;
+    bool                                  m_isExpanded;
+    bool                                  m_isPinned;
+    bool                                  m_isTooltipShown;
+    int                                   m_updateDepth;
+    int                                   m_nextSubscription;
 
     Q_OBJECT
 
+    friend class OfficeMenuHeader;
+    friend class OfficeMenuItem;
+    friend class OfficeMenuPanel;
     friend class priv::PinButton;
 };
 
@@ -0,0 +1,218 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// QOffice - The office framework for Qt
+// Copyright (C) 2016-2018 Nicolas Kogler
+//
+// This file is part of the Widget module.
+//
+// QOffice is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// QOffice is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with QOffice. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#ifndef QOFFICE_WIDGETS_OFFICEMENUCOMMANDEXECUTOR_HPP
+#define QOFFICE_WIDGETS_OFFICEMENUCOMMANDEXECUTOR_HPP
+
+#include <QOffice/Widgets/OfficeMenuEventHandle.hpp>
+#include <QHash>
+#include <QObject>
+#include <QThreadPool>
+#include <QVariant>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+class OfficeMenu;
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class OfficeMenuCommandExecutor
+/// \ingroup Widget
+///
+/// \brief Runs the commands of menu items on a thread pool.
+///
+/// Slots connected to the signals of ::OfficeMenu run on the GUI thread and
+/// freeze the whole window while they are busy. The executor instead maps item
+/// IDs to commands that run on its own thread pool and reports their results
+/// back to the GUI thread:
+///
+/// \code
+/// auto* executor = new OfficeMenuCommandExecutor(menu);
+/// executor->registerCommand(c_search, OfficeMenuEvent::TextChanged,
+///     [] (const OfficeMenuEventHandle& event, const std::atomic<bool>& cancelled)
+///         {
+///             auto text = event.as<OfficeMenuTextChangedEvent>()->currentText();
+///             return QVariant(search(text, cancelled));
+///         });
+///
+/// QObject::connect(executor, &OfficeMenuCommandExecutor::commandFinished, ...);
+/// \endcode
+///
+/// Commands should poll the cancellation flag and return early once it is set.
+/// While a command runs, the widget of its item shows a busy cursor.
+///
+/// \remarks Only events emitted through ::OfficeMenuEventHandle (see
+///          OfficeMenu::sharedItemEvent) trigger commands.
+///
+////////////////////////////////////////////////////////////////////////////////
+class QOFFICE_WIDGET_API OfficeMenuCommandExecutor : public QObject
+{
+public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Defines what happens if an item triggers its command again while
+    ///        the command is still running.
+    /// \enum TriggerPolicy
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    enum TriggerPolicy
+    {
+        RestartLatest,  ///< Cancels the running command and runs the latest.
+        QueueLatest,    ///< Runs the latest trigger after the running command.
+        IgnoreWhileBusy ///< Ignores all triggers while the command runs.
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Executes a command on a worker thread.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    typedef std::function<QVariant(
+        const OfficeMenuEventHandle&,
+        const std::atomic<bool>&
+        )> Command;
+
+    OffDeclareDtor(OfficeMenuCommandExecutor)
+    OffDisableCopy(OfficeMenuCommandExecutor)
+    OffDisableMove(OfficeMenuCommandExecutor)
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Initializes a new executor for the items of the given \p menu. The
+    /// executor is owned by the menu.
+    ///
+    /// \param[in] menu The menu whose item events trigger commands.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    OfficeMenuCommandExecutor(OfficeMenu* menu);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the thread pool the commands run on.
+    ///
+    /// \return The thread pool of this executor.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    QThreadPool* threadPool();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Registers the \p command of the item with the given \p itemId. Any
+    /// previous command of the item is replaced; if it is running, the next
+    /// trigger is handled according to \p policy until the run finishes.
+    ///
+    /// \param[in] itemId The ID of the item that triggers the command.
+    /// \param[in] type The event type that triggers the command, or
+    ///            OfficeMenuEvent::Invalid for all types.
+    /// \param[in] command The command to run on the thread pool.
+    /// \param[in] policy Specifies how repeated triggers are handled.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void registerCommand(
+        int itemId,
+        OfficeMenuEvent::Type type,
+        Command command,
+        TriggerPolicy policy = RestartLatest
+        );
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Unregisters the command of the item with the given \p itemId. A running
+    /// command is cancelled.
+    ///
+    /// \param[in] itemId The ID of the item.
+    /// \return True if unregistered, false if there was no command.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool unregisterCommand(int itemId);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Cancels the running and the queued command of the given item.
+    ///
+    /// \param[in] itemId The ID of the item.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void cancel(int itemId);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether the command of the given item is running.
+    ///
+    /// \param[in] itemId The ID of the item.
+    /// \return True if busy, false otherwise.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool isBusy(int itemId) const;
+
+signals:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// This signal is emitted once a command of the given item starts or stops
+    /// running, including queued re-runs.
+    ///
+    /// \param[in] itemId The ID of the item.
+    /// \param[in] busy True if a command is running, false otherwise.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void busyChanged(int itemId, bool busy);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// This signal is emitted on the GUI thread once a command completed.
+    ///
+    /// \param[in] itemId The ID of the item.
+    /// \param[in] result The value returned by the command.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void commandFinished(int itemId, QVariant result);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// This signal is emitted on the GUI thread once a cancelled command
+    /// returned. Its result is discarded.
+    ///
+    /// \param[in] itemId The ID of the item.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void commandCancelled(int itemId);
+
+private slots:
+
+    void onItemEvent(OfficeMenuEventHandle event);
+
+private:
+
+    struct Entry
+    {
+        Command                            command;
+        OfficeMenuEvent::Type              type;
+        TriggerPolicy                      policy;
+        std::shared_ptr<std::atomic<bool>> cancelled;
+        OfficeMenuEventHandle              pending;
+        bool                               isRunning;
+    };
+
+    void start(int, Entry&, const OfficeMenuEventHandle&);
+    void finish(int, const std::shared_ptr<std::atomic<bool>>&, const QVariant&);
+    void setBusy(int, bool);
+
+    OfficeMenu*        m_menu;
+    QThreadPool        m_pool;
+    QHash<int, Entry>  m_commands;
+
+    Q_OBJECT
+};
+
+#endif
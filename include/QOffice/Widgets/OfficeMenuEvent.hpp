@@ -50,7 +50,11 @@ public:
         TextChanged,
         ButtonClicked,
         ItemChanged,
-        UserEvent
+        UserEvent,
+
+        // Types added later take negative values, so that UserEvent and all
+        // client types derived from it keep their values.
+        TextEdited = -2
     };
 
     OffDefaultDtor(OfficeMenuEvent)
@@ -93,12 +97,18 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     /// Accepts the event.
     ///
+    /// \remarks Has no effect on events held by an ::OfficeMenuEventHandle,
+    ///          since they may be read by other threads at the same time.
+    ///
     ////////////////////////////////////////////////////////////////////////////
     void accept();
 
     ////////////////////////////////////////////////////////////////////////////
     /// Ignores the event.
     ///
+    /// \remarks Has no effect on events held by an ::OfficeMenuEventHandle,
+    ///          since they may be read by other threads at the same time.
+    ///
     ////////////////////////////////////////////////////////////////////////////
     void ignore();
 
@@ -110,6 +120,9 @@ private:
     Type         m_type;     ///< Defines the type of the event.
     int          m_id;       ///< Defines the ID of the item.
     mutable bool m_accepted; ///< Determines whether this event was accepted.
+    bool         m_isShared; ///< Determines whether a handle holds this event.
+
+    friend class OfficeMenuEventHandle;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -282,6 +295,70 @@ private:
     QVariant m_value; ///< Defines the underlying value of the item.
 };
 
+////////////////////////////////////////////////////////////////////////////////
+/// \class OfficeMenuTextEditedEvent
+/// \brief Defines an event that describes a text change as a single edit.
+///
+////////////////////////////////////////////////////////////////////////////////
+class QOFFICE_WIDGET_API OfficeMenuTextEditedEvent : public OfficeMenuEvent
+{
+public:
+
+    OffDefaultDtor(OfficeMenuTextEditedEvent)
+    OffDisableCopy(OfficeMenuTextEditedEvent)
+    OffDisableMove(OfficeMenuTextEditedEvent)
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Constructs a new OfficeMenuTextEditedEvent.
+    ///
+    /// \param[in] id The unique identifier of the item.
+    /// \param[in] position The position of the first changed character.
+    /// \param[in] removed The amount of characters removed at \p position.
+    /// \param[in] inserted The text inserted at \p position.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    OfficeMenuTextEditedEvent(
+        int id,
+        int position,
+        int removed,
+        const QString& inserted
+        );
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the position of the first changed character.
+    ///
+    /// \return The position of the edit.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int position() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the amount of characters removed at the position.
+    ///
+    /// \return The amount of removed characters.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int removedLength() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the text inserted at the position.
+    ///
+    /// \return The inserted text.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    const QString& insertedText() const;
+
+private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Members
+    //
+    ////////////////////////////////////////////////////////////////////////////
+    int m_position;     ///< Defines the position of the first changed character.
+    int m_removed;      ///< Defines the amount of removed characters.
+    QString m_inserted; ///< Defines the inserted text.
+};
+
 #endif
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -427,3 +504,21 @@ private:
 /// \endcode
 ///
 ////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class OfficeMenuTextEditedEvent
+/// \ingroup Widget
+///
+/// This event is emitted along with ::OfficeMenuTextChangedEvent, but only
+/// carries the edited part of the text. Replaying the edits on a copy of the
+/// initial text always yields the current text.
+///
+/// \code
+/// void textEditedEvent(OfficeMenuTextEditedEvent* event)
+/// {
+///     m_query.replace(event->position(), event->removedLength(),
+///                     event->insertedText());
+/// }
+/// \endcode
+///
+////////////////////////////////////////////////////////////////////////////////
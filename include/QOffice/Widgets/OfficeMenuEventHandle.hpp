@@ -0,0 +1,232 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// QOffice - The office framework for Qt
+// Copyright (C) 2016-2018 Nicolas Kogler
+//
+// This file is part of the Widget module.
+//
+// QOffice is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// QOffice is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with QOffice. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#ifndef QOFFICE_WIDGETS_OFFICEMENUEVENTHANDLE_HPP
+#define QOFFICE_WIDGETS_OFFICEMENUEVENTHANDLE_HPP
+
+#include <QOffice/Widgets/OfficeMenuEvent.hpp>
+#include <QAtomicInt>
+#include <QMetaType>
+#include <QMutex>
+#include <QVector>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace priv
+{
+struct EventBlock
+{
+    QAtomicInt       refs;
+    OfficeMenuEvent* event;
+    void           (*recycle)(EventBlock*);
+};
+
+// Recycles the memory of released events of type T, so that events on hot
+// paths stop allocating once the pool is warm. Blocks may be released from
+// any thread, hence the free list is guarded.
+template <typename T>
+class EventPool
+{
+public:
+
+    struct Block
+    {
+        EventBlock                                                 header;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    template <typename... Args>
+    static EventBlock* acquire(Args&&... args)
+    {
+        Block* block = nullptr;
+        {
+            EventPool& pool = instance();
+            QMutexLocker lock(&pool.m_mutex);
+
+            if (!pool.m_free.isEmpty())
+            {
+                block = pool.m_free.takeLast();
+            }
+        }
+
+        if (block == nullptr)
+        {
+            block = new Block;
+        }
+
+        block->header.refs.store(1);
+        block->header.event = new (&block->storage) T(std::forward<Args>(args)...);
+        block->header.recycle = &EventPool::recycle;
+
+        return &block->header;
+    }
+
+    ~EventPool()
+    {
+        qDeleteAll(m_free);
+    }
+
+private:
+
+    static QOFFICE_CONSTEXPR int c_capacity = 64;
+
+    static EventPool& instance()
+    {
+        static EventPool pool;
+        return pool;
+    }
+
+    static void recycle(EventBlock* header)
+    {
+        // The header is the first member of the block.
+        Block* block = reinterpret_cast<Block*>(header);
+        static_cast<T*>(header->event)->~T();
+
+        EventPool& pool = instance();
+        QMutexLocker lock(&pool.m_mutex);
+
+        if (pool.m_free.size() < c_capacity)
+        {
+            pool.m_free.append(block);
+        }
+        else
+        {
+            delete block;
+        }
+    }
+
+    QMutex          m_mutex;
+    QVector<Block*> m_free;
+};
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class OfficeMenuEventHandle
+/// \ingroup Widget
+///
+/// \brief Holds a shared, immutable reference to a pooled ::OfficeMenuEvent.
+///
+/// Unlike a plain ::OfficeMenuEvent, which lives on the stack of the item that
+/// emits it, a handle may be copied freely and outlives the emitting item. It
+/// is registered with the meta-type system and can therefore be delivered to
+/// worker threads through queued connections:
+///
+/// \code
+/// QObject::connect(
+///     menu, &OfficeMenu::sharedItemEvent,
+///     worker, &Worker::onItemEvent,
+///     Qt::QueuedConnection
+///     );
+///
+/// void Worker::onItemEvent(OfficeMenuEventHandle handle)
+/// {
+///     if (handle->type() == OfficeMenuEvent::TextChanged)
+///     {
+///         search(handle.as<OfficeMenuTextChangedEvent>()->currentText());
+///     }
+/// }
+/// \endcode
+///
+/// Events are allocated from a per-type pool and returned to it once the last
+/// handle is destroyed, on whatever thread that happens to be.
+///
+////////////////////////////////////////////////////////////////////////////////
+class QOFFICE_WIDGET_API OfficeMenuEventHandle
+{
+public:
+
+    OffDeclareCtor(OfficeMenuEventHandle)
+    OffDeclareCopy(OfficeMenuEventHandle)
+    OffDeclareMove(OfficeMenuEventHandle)
+
+    ~OfficeMenuEventHandle();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Creates a new event of type \p T from the pool and forwards the given
+    /// \p args to its constructor.
+    ///
+    /// \param[in] args The constructor arguments of the event.
+    /// \return A handle to the new event.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    template <typename T, typename... Args>
+    static OfficeMenuEventHandle create(Args&&... args)
+    {
+        static_assert(
+            std::is_base_of<OfficeMenuEvent, T>::value,
+            "T must derive from OfficeMenuEvent"
+            );
+
+        return OfficeMenuEventHandle(
+            priv::EventPool<T>::acquire(std::forward<Args>(args)...)
+            );
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether this handle refers to an event.
+    ///
+    /// \return True if this handle is empty, false otherwise.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool isNull() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the event this handle refers to.
+    ///
+    /// \return The event, or nullptr if this handle is empty.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    const OfficeMenuEvent* event() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the event this handle refers to, cast to the given type. The
+    /// type of the event must be checked before.
+    ///
+    /// \return The event of type \p T.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    template <typename T>
+    const T* as() const
+    {
+        return static_cast<const T*>(event());
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Accesses the members of the event this handle refers to.
+    ///
+    /// \return The event.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    const OfficeMenuEvent* operator ->() const;
+
+private:
+
+    explicit OfficeMenuEventHandle(priv::EventBlock* block);
+
+    priv::EventBlock* m_block;
+};
+
+Q_DECLARE_METATYPE(OfficeMenuEventHandle)
+
+#endif
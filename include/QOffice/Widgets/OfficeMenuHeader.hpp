@@ -25,14 +25,36 @@
 #define QOFFICE_WIDGET_OFFICEMENUHEADER_HPP
 
 #include <QOffice/Config.hpp>
+#include <QHash>
 #include <QWidget>
+#include <functional>
 
 class OfficeMenu;
+class OfficeMenuItem;
 class OfficeMenuPanel;
-class QGraphicsOpacityEffect;
 class QHBoxLayout;
+class QPropertyAnimation;
 
-namespace priv { class PanelBar; }
+namespace priv
+{
+class PanelBar;
+class PanelBarSnapshot;
+struct ItemDeclaration
+{
+    int                              id;
+    std::function<OfficeMenuItem*()> factory;
+    int                              row;
+    int                              column;
+    int                              rowSpan;
+    int                              columnSpan;
+};
+struct PanelDeclaration
+{
+    int                    id;
+    QString                text;
+    QList<ItemDeclaration> items;
+};
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 /// \class OfficeMenuHeader
@@ -40,12 +62,23 @@ namespace priv { class PanelBar; }
 /// \author Nicolas Kogler
 /// \date September 30, 2017
 ///
+/// The panels of a header can either be created right away through
+/// OfficeMenuHeader::insertPanel or merely be declared through
+/// OfficeMenuHeader::declarePanel and OfficeMenuHeader::declareItem. Declared
+/// panels and items are not built until the header is expanded for the first
+/// time, which keeps menus with many headers cheap to create:
+///
+/// \code
+/// header->declarePanel(1, "Clipboard");
+/// header->declareItem(1, 10, [] { return new OfficeMenuTextboxItem("Paste"); }, 0, 0);
+/// \endcode
+///
 ////////////////////////////////////////////////////////////////////////////////
 class QOFFICE_WIDGET_API OfficeMenuHeader : public QWidget
 {
 public:
 
-    OffDefaultDtor(OfficeMenuHeader)
+    OffDeclareDtor(OfficeMenuHeader)
     OffDisableCopy(OfficeMenuHeader)
     OffDisableMove(OfficeMenuHeader)
 
@@ -113,13 +146,25 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     OfficeMenuPanel* operator [](int id) const;
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether the panel bar and all declared panels of this header
+    /// have been built.
+    ///
+    /// \return True if materialized, false otherwise.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool isMaterialized() const;
+
     ////////////////////////////////////////////////////////////////////////////
     /// Specifies the unique identifier of this object.
     ///
     /// \param[in] id The new unique identifier.
+    /// \return True if successfully changed, false otherwise.
+    ///
+    /// \remarks Yields false if another header of the menu already has the id.
     ///
     ////////////////////////////////////////////////////////////////////////////
-    void setId(int id);
+    bool setId(int id);
 
     ////////////////////////////////////////////////////////////////////////////
     /// Specifies the displayed text of this header.
@@ -168,6 +213,52 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     bool removePanel(int id);
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Declares a panel that is appended to this header once it is
+    /// materialized. If this header is already materialized, this is
+    /// equivalent to calling OfficeMenuHeader::appendPanel.
+    ///
+    /// \param[in] id The unique identifier of the new panel.
+    /// \param[in] text The displayed text of the new panel.
+    /// \return True if declared successfully, false otherwise.
+    ///
+    /// \remarks If the given \p id already exists, false is returned.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool declarePanel(int id, const QString& text);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Declares an item within the panel \p panelId. The \p factory is not
+    /// invoked before this header is materialized. If this header is already
+    /// materialized, the item is created and inserted immediately.
+    ///
+    /// \param[in] panelId The id of the panel that will contain the item.
+    /// \param[in] id The unique item id within the panel.
+    /// \param[in] factory Creates the item on demand.
+    /// \param[in] row The row of the item within the panel.
+    /// \param[in] column The column of the item within the panel.
+    /// \param[in] rowSpan The amount of rows the item spans.
+    /// \param[in] columnSpan The amount of columns the item spans.
+    /// \return True if declared successfully, false otherwise.
+    ///
+    /// \remarks Yields false if \p panelId is invalid or \p id already exists.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool declareItem(
+        int panelId, int id,
+        std::function<OfficeMenuItem*()> factory,
+        int row, int column,
+        int rowSpan = 1, int columnSpan = 1
+        );
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Builds the panel bar and all declared panels and items of this header.
+    /// This is done automatically on the first expansion, but can be forced in
+    /// order to access declared panels through OfficeMenuHeader::panelById.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void materialize();
+
     ////////////////////////////////////////////////////////////////////////////
     /// Retrieves the preferred size for this header.
     ///
@@ -204,24 +295,31 @@ private slots:
 
 private:
 
+    void createPanelBar();
+    void showSnapshot(QPropertyAnimation*, int, int);
+    void stopSnapshot();
     void expand(QHBoxLayout*,bool);
     void collapse(QHBoxLayout*,bool);
 
-    OfficeMenu*             m_parent;
-    priv::PanelBar*         m_panelBar;
-    QHBoxLayout*            m_panelLayout;
-    QGraphicsOpacityEffect* m_effectIn;
-    QPropertyAnimation*     m_animationIn;
-    QPropertyAnimation*     m_animationOut;
-    QList<OfficeMenuPanel*> m_panels;
-    QString                 m_text;
-    bool                    m_isHovered;
-    bool                    m_isSelected;
-    int                     m_id;
+    OfficeMenu*                   m_parent;
+    priv::PanelBar*               m_panelBar;
+    priv::PanelBarSnapshot*       m_snapshot;
+    QHBoxLayout*                  m_panelLayout;
+    QPropertyAnimation*           m_animationIn;
+    QPropertyAnimation*           m_animationOut;
+    QList<OfficeMenuPanel*>       m_panels;
+    QHash<int, OfficeMenuPanel*>  m_panelIndex;
+    QList<priv::PanelDeclaration> m_declaredPanels;
+    QString                       m_text;
+    bool                          m_isHovered;
+    bool                          m_isSelected;
+    int                           m_id;
 
     Q_OBJECT
 
     friend class OfficeMenu;
+    friend class OfficeMenuPanel;
+    friend class priv::PanelBar;
 };
 
 #endif
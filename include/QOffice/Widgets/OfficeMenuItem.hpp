@@ -26,8 +26,10 @@
 
 #include <QOffice/Config.hpp>
 #include <QObject>
+#include <QString>
 
 class OfficeMenuEvent;
+class OfficeMenuEventHandle;
 class OfficeMenuPanel;
 class QWidget;
 
@@ -77,6 +79,7 @@ class QOFFICE_WIDGET_API OfficeMenuItem
 {
 public:
 
+    OffDeclareCtor(OfficeMenuItem)
     OffDefaultDtor(OfficeMenuItem)
 
     ////////////////////////////////////////////////////////////////////////////
@@ -95,13 +98,24 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     OfficeMenuPanel* panel() const;
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the text this item is found by through OfficeMenu::search.
+    ///
+    /// \return The search text of this item.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    const QString& searchText() const;
+
     ////////////////////////////////////////////////////////////////////////////
     /// Specifies the unique identifier of this object.
     ///
     /// \param[in] id The new unique identifier.
+    /// \return True if successfully changed, false otherwise.
+    ///
+    /// \remarks Yields false if another item of the panel already has the id.
     ///
     ////////////////////////////////////////////////////////////////////////////
-    void setId(int id);
+    bool setId(int id);
 
     ////////////////////////////////////////////////////////////////////////////
     /// Specifies the parent panel of this item.
@@ -111,6 +125,16 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     void setPanel(OfficeMenuPanel* panel);
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the text this item is found by through OfficeMenu::search,
+    /// typically the label or the name of its command. Items without search
+    /// text are not searchable.
+    ///
+    /// \param[in] text The new search text.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setSearchText(const QString& text);
+
     ////////////////////////////////////////////////////////////////////////////
     /// Retrieves the underlying widget of this menu item.
     ///
@@ -130,9 +154,23 @@ protected:
     ////////////////////////////////////////////////////////////////////////////
     void emitItemEvent(OfficeMenuEvent* event);
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Emits a pooled item event. In addition to the signals the plain event
+    /// is delivered to, it is passed to OfficeMenu::sharedItemEvent, which may
+    /// be connected to receivers on other threads.
+    ///
+    /// \param event The event to emit.
+    ///
+    /// \remarks See ::OfficeMenuEventHandle. The event is immutable; handlers
+    ///          can neither accept nor ignore it.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void emitItemEvent(const OfficeMenuEventHandle& event);
+
 private:
 
     OfficeMenuPanel* m_parent;
+    QString          m_searchText;
     int              m_id;
 };
 
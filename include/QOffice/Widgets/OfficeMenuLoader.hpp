@@ -0,0 +1,200 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// QOffice - The office framework for Qt
+// Copyright (C) 2016-2018 Nicolas Kogler
+//
+// This file is part of the Widget module.
+//
+// QOffice is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// QOffice is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with QOffice. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#ifndef QOFFICE_WIDGETS_OFFICEMENULOADER_HPP
+#define QOFFICE_WIDGETS_OFFICEMENULOADER_HPP
+
+#include <QOffice/Config.hpp>
+#include <QHash>
+#include <QJsonObject>
+#include <QString>
+#include <functional>
+
+class OfficeMenu;
+class OfficeMenuItem;
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class OfficeMenuLoader
+/// \ingroup Widget
+///
+/// \brief Builds the headers, panels and items of an ::OfficeMenu from a
+///        declarative ribbon definition.
+///
+/// The definition is either a JSON document or its CBOR equivalent (requires
+/// Qt 5.12 or newer) and looks as follows:
+///
+/// \code
+/// {
+///     "headers": [ {
+///         "id": 1, "text": "Home",
+///         "panels": [ {
+///             "id": 1, "text": "Clipboard",
+///             "items": [ {
+///                 "id": 1, "type": "textbox", "text": "Paste",
+///                 "row": 0, "column": 0, "rowSpan": 1, "columnSpan": 1
+///             } ]
+///         } ]
+///     } ]
+/// }
+/// \endcode
+///
+/// Textbox items may additionally specify a "coalesce" period in milliseconds,
+/// see OfficeLineEdit::setCoalescePeriod. Gallery items list their "entries"
+/// as objects with a "text", a "thumbnail" path and an optional "value", and
+/// may specify a square "thumbnailSize". Dropdown items list their "entries"
+/// as strings or as objects with a "text" and an optional "value", and may
+/// choose a "current" row. Font picker items may restrict their "families"
+/// to a list of names and choose a "current" family. Items of any type may
+/// specify a "searchText", see OfficeMenuItem::setSearchText.
+///
+/// The whole definition is validated before a single widget is created, hence
+/// an invalid definition never leaves a half-built menu behind. Custom item
+/// types can be added through OfficeMenuLoader::registerItemType; the
+/// factory receives the JSON object of the item and may read any additional
+/// keys from it.
+///
+////////////////////////////////////////////////////////////////////////////////
+class QOFFICE_WIDGET_API OfficeMenuLoader
+{
+public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Defines the encoding of a ribbon definition.
+    /// \enum Format
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    enum Format
+    {
+        Json,
+        Cbor
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Holds the time spent in each stage of the last load, in
+    ///        nanoseconds.
+    /// \struct Timings
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    struct Timings
+    {
+        qint64 parse;
+        qint64 validate;
+        qint64 build;
+        qint64 attach;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Creates a menu item from the JSON object that describes it.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    typedef std::function<OfficeMenuItem*(const QJsonObject&)> ItemFactory;
+
+    OffDeclareCtor(OfficeMenuLoader)
+    OffDefaultDtor(OfficeMenuLoader)
+    OffDisableCopy(OfficeMenuLoader)
+    OffDisableMove(OfficeMenuLoader)
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Registers a factory for the given item \p type. Registering an existing
+    /// type replaces its factory. The types "textbox", "gallery",
+    /// "dropdown" and "fontpicker" are registered by default.
+    ///
+    /// \param[in] type The value of the "type" key in the definition.
+    /// \param[in] factory Creates the item from its JSON object.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void registerItemType(const QString& type, ItemFactory factory);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether panels are only declared instead of built.
+    ///
+    /// \return True if panels are built on first expansion, false otherwise.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool isLazy() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies whether panels and items should only be declared and built
+    /// once their header is expanded for the first time.
+    ///
+    /// \param[in] lazy True to declare panels lazily, false otherwise.
+    ///
+    /// \remarks See OfficeMenuHeader::declarePanel.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setLazy(bool lazy);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Parses and validates the given definition and appends all of its
+    /// headers to the given \p menu.
+    ///
+    /// \param[in] menu The menu to populate.
+    /// \param[in] data The encoded ribbon definition.
+    /// \param[in] format The encoding of \p data.
+    /// \return True if loaded successfully, false otherwise.
+    ///
+    /// \remarks The menu is left untouched if false is returned.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool load(OfficeMenu* menu, const QByteArray& data, Format format = Json);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Reads the file at the given \p path and loads it. Files ending with
+    /// ".cbor" are treated as CBOR, all other files as JSON.
+    ///
+    /// \param[in] menu The menu to populate.
+    /// \param[in] path The path to the ribbon definition.
+    /// \return True if loaded successfully, false otherwise.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool loadFile(OfficeMenu* menu, const QString& path);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the reason the last load failed.
+    ///
+    /// \return The error message, or an empty string on success.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    const QString& errorString() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the time spent in each stage of the last load.
+    ///
+    /// \return The timings of the last load.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    const Timings& timings() const;
+
+private:
+
+    bool parse(const QByteArray&, Format, QJsonObject&);
+    bool validate(const OfficeMenu*, const QJsonObject&);
+    void build(OfficeMenu*, const QJsonObject&);
+
+    QHash<QString, ItemFactory> m_factories;
+    QString                     m_errorString;
+    Timings                     m_timings;
+    bool                        m_isLazy;
+};
+
+#endif
@@ -25,6 +25,7 @@
 #define QOFFICE_WIDGET_OFFICEMENUPANEL_HPP
 
 #include <QOffice/Config.hpp>
+#include <QHash>
 #include <QWidget>
 
 class OfficeMenu;
@@ -108,6 +109,14 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     const QString& text() const;
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the collapse priority of this panel.
+    ///
+    /// \return The collapse priority.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int collapsePriority() const;
+
     ////////////////////////////////////////////////////////////////////////////
     /// Retrieves the item with the specified \p id.
     ///
@@ -135,9 +144,12 @@ public:
     /// Specifies the unique identifier of this object.
     ///
     /// \param[in] id The new unique identifier.
+    /// \return True if successfully changed, false otherwise.
+    ///
+    /// \remarks Yields false if another panel of the header already has the id.
     ///
     ////////////////////////////////////////////////////////////////////////////
-    void setId(int id);
+    bool setId(int id);
 
     ////////////////////////////////////////////////////////////////////////////
     /// Specifies the displayed panel text.
@@ -147,6 +159,18 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     void setText(const QString& text);
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the collapse priority of this panel. If the panel bar is too
+    /// narrow to hold all panels, panels are replaced by a drop-down button
+    /// that shows the panel in a popup, lowest priority first, until the rest
+    /// fits. Panels of equal priority collapse from right to left. The default
+    /// priority is zero.
+    ///
+    /// \param[in] priority The new collapse priority.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setCollapsePriority(int priority);
+
     ////////////////////////////////////////////////////////////////////////////
     /// Inserts a new menu item into the panel.
     ///
@@ -187,20 +211,28 @@ public:
 
 protected:
 
+    virtual bool event(QEvent*) override;
     virtual void paintEvent(QPaintEvent*) override;
 
 private:
 
-    QGridLayout*           m_layout;
-    OfficeMenuHeader*      m_parent;
-    QList<OfficeMenuItem*> m_items;
-    QString                m_text;
-    int                    m_id;
+    bool reindexItem(OfficeMenuItem*, int);
+    void invalidateSizeHint();
+
+    QGridLayout*                m_layout;
+    OfficeMenuHeader*           m_parent;
+    QList<OfficeMenuItem*>      m_items;
+    QHash<int, OfficeMenuItem*> m_itemIndex;
+    QString                     m_text;
+    mutable QSize               m_sizeHint;
+    int                         m_collapsePriority;
+    int                         m_id;
 
     Q_OBJECT
 
     friend class OfficeMenu;
     friend class OfficeMenuHeader;
+    friend class OfficeMenuItem;
 };
 
 #endif
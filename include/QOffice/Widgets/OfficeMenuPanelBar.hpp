@@ -25,12 +25,55 @@
 #define QOFFICE_WIDGETS_OFFICEMENUPANELBAR_HPP
 
 #include <QOffice/Config.hpp>
+#include <QPixmap>
+#include <QPointer>
+#include <QVector>
 #include <QWidget>
 
 class OfficeMenu;
+class OfficeMenuHeader;
+class OfficeMenuPanel;
+class TestPanelBar;
 
 namespace priv
 {
+// Stands in for a panel that does not fit into the panel bar. Clicking it
+// shows the panel in a popup below the button.
+class PanelButton : public QWidget
+{
+public:
+
+    OffDefaultDtor(PanelButton)
+    OffDisableCopy(PanelButton)
+    OffDisableMove(PanelButton)
+
+    PanelButton(QWidget* parent, OfficeMenuPanel* panel);
+
+    static int widthFor(const QFontMetrics& metrics, const QString& text);
+
+    void attachPanel();
+    void detachPanel();
+
+    QSize sizeHint() const override;
+
+protected:
+
+    void paintEvent(QPaintEvent*) override;
+    void enterEvent(QEvent*) override;
+    void leaveEvent(QEvent*) override;
+    void mousePressEvent(QMouseEvent*) override;
+
+private:
+
+    OfficeMenuPanel* m_panel;
+    QWidget*         m_popup;
+    bool             m_isHovered;
+};
+
+// Lays out the panels of a header. Whenever the width changes, panels are
+// replaced by a PanelButton, lowest collapse priority first, until the rest
+// fits. Widths are measured once per change of the panels, hence a resize
+// only costs a single pass over the cached widths.
 class PanelBar : public QWidget
 {
 public:
@@ -39,9 +82,64 @@ public:
     OffDisableCopy(PanelBar)
     OffDisableMove(PanelBar)
 
-    PanelBar(OfficeMenu* parent);
+    PanelBar(OfficeMenu* parent, OfficeMenuHeader* header);
+
+    void invalidate();
+    void adapt();
+    void release(OfficeMenuPanel* panel);
 
     QSize sizeHint() const override;
+
+protected:
+
+    void resizeEvent(QResizeEvent*) override;
+
+private:
+
+    struct PanelState
+    {
+        OfficeMenuPanel* panel;
+        PanelButton*     button;
+        int              fullWidth;
+        int              reducedWidth;
+        bool             isCollapsed;
+    };
+
+    void measure();
+    void setCollapsed(PanelState&, bool);
+
+    QPointer<OfficeMenuHeader> m_header;
+    QVector<PanelState>        m_states;
+    QVector<int>               m_order;
+    int                        m_reservedWidth;
+    bool                       m_isDirty;
+    bool                       m_isScheduled;
+
+    friend class ::TestPanelBar;
+};
+
+// Stands in for the panel bar while it is being revealed or hidden. It only
+// blits a pixmap of the panel bar, so animating its size costs the same no
+// matter how many items the panel bar holds.
+class PanelBarSnapshot : public QWidget
+{
+public:
+
+    OffDefaultDtor(PanelBarSnapshot)
+    OffDisableCopy(PanelBarSnapshot)
+    OffDisableMove(PanelBarSnapshot)
+
+    PanelBarSnapshot(OfficeMenu* parent);
+
+    void setPixmap(const QPixmap& pixmap);
+
+protected:
+
+    void paintEvent(QPaintEvent*) override;
+
+private:
+
+    QPixmap m_pixmap;
 };
 }
 
@@ -28,7 +28,6 @@
 #include <QWidget>
 
 class OfficeMenuHeader;
-class OfficeTooltip;
 
 namespace priv
 {
@@ -55,7 +54,6 @@ protected:
 private:
 
     OfficeMenuHeader* m_parent;
-    OfficeTooltip*    m_tooltip;
     QPixmap           m_imgSticky;
     QPixmap           m_imgCollapse;
     bool              m_isHovered;
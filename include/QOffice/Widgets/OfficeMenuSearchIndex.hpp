@@ -0,0 +1,173 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// QOffice - The office framework for Qt
+// Copyright (C) 2016-2018 Nicolas Kogler
+//
+// This file is part of the Widget module.
+//
+// QOffice is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// QOffice is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with QOffice. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#ifndef QOFFICE_WIDGETS_OFFICEMENUSEARCHINDEX_HPP
+#define QOFFICE_WIDGETS_OFFICEMENUSEARCHINDEX_HPP
+
+#include <QOffice/Config.hpp>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+class OfficeMenuHeader;
+class OfficeMenuItem;
+class OfficeMenuPanel;
+class TestSearchIndex;
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class OfficeMenuSearchIndex
+/// \ingroup Widget
+///
+/// \brief Finds headers, panels and items of an ::OfficeMenu by their text.
+///
+/// Every ::OfficeMenu maintains an index of the texts of its headers, panels
+/// and items while they are inserted and removed; use OfficeMenu::search to
+/// query it. A query matches a text if its characters appear in the text in
+/// the same order, ignoring case. Prefixes rank before word prefixes, which
+/// rank before substrings, which rank before scattered matches:
+///
+/// \code
+/// for (const auto& match : menu->search("inspic"))
+/// {
+///     qDebug() << match.text; // "Insert Picture", ...
+/// }
+/// \endcode
+///
+/// A query that extends the previous one only re-examines the previous matches,
+/// hence typing a query character by character stays cheap even for tens of
+/// thousands of entries.
+///
+////////////////////////////////////////////////////////////////////////////////
+class QOFFICE_WIDGET_API OfficeMenuSearchIndex
+{
+public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Holds a single search result.
+    /// \struct Match
+    ///
+    /// The most specific of the pointers denotes the match itself; the others
+    /// denote its owners. OfficeMenu::reveal expands the header of a match.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    struct Match
+    {
+        OfficeMenuHeader* header;
+        OfficeMenuPanel*  panel;
+        OfficeMenuItem*   item;
+        QString           text;
+        int               score;
+    };
+
+    OffDeclareCtor(OfficeMenuSearchIndex)
+    OffDefaultDtor(OfficeMenuSearchIndex)
+    OffDisableCopy(OfficeMenuSearchIndex)
+    OffDisableMove(OfficeMenuSearchIndex)
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the amount of indexed entries.
+    ///
+    /// \return The amount of entries.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int size() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Indexes the given \p text. The entry is owned by the most specific of
+    /// the given pointers, i.e. the \p item if not null, the \p panel if not
+    /// null, the \p header otherwise. An existing entry of the owner is
+    /// replaced.
+    ///
+    /// \param[in] text The text to find the entry by.
+    /// \param[in] header The header of the entry.
+    /// \param[in] panel The panel of the entry, if any.
+    /// \param[in] item The item of the entry, if any.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void insert(
+        const QString& text,
+        OfficeMenuHeader* header,
+        OfficeMenuPanel* panel = nullptr,
+        OfficeMenuItem* item = nullptr
+        );
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Changes the text of the entry owned by \p owner.
+    ///
+    /// \param[in] owner The header, panel or item that owns the entry.
+    /// \param[in] text The new text of the entry.
+    /// \return True if changed, false if \p owner has no entry.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool update(const void* owner, const QString& text);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Removes the entry owned by \p owner.
+    ///
+    /// \param[in] owner The header, panel or item that owns the entry.
+    /// \return True if removed, false if \p owner has no entry.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool remove(const void* owner);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Removes all entries.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void clear();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Finds the entries that match the given \p query.
+    ///
+    /// \param[in] query The text to search for.
+    /// \param[in] limit The maximum amount of matches to return.
+    /// \return The best matches, best first.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    QVector<Match> search(const QString& query, int limit = 10);
+
+private:
+
+    struct Entry
+    {
+        Match   match;
+        QString folded;
+        quint64 mask;
+        bool    isAlive;
+    };
+
+    void invalidate();
+    static QString fold(const QString&);
+    static quint64 maskOf(const QString&);
+    static int score(const Entry&, const QString&);
+
+    QVector<Entry>           m_entries;
+    QVector<int>             m_free;
+    QHash<const void*, int>  m_slots;
+    QVector<int>             m_lastCandidates;
+    QString                  m_lastQuery;
+
+    friend class ::TestSearchIndex;
+};
+
+#endif
@@ -25,9 +25,29 @@
 #define QOFFICE_WIDGETS_OFFICETOOLTIP_HPP
 
 #include <QOffice/Config.hpp>
+#include <QImage>
 #include <QWidget>
+#include <memory>
 
 class OfficeWindow;
+class QPainter;
+
+namespace priv
+{
+struct TooltipJob;
+struct TooltipLayout
+{
+    QRect  heading;
+    QRect  body;
+    QRect  separator;
+    QRect  icon;
+    QRect  help;
+    QRect  client;
+    QRect  border;
+    int    height;
+    QImage dropShadow;
+};
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 /// \class OfficeTooltip
@@ -61,6 +81,22 @@ class QOFFICE_WIDGET_API OfficeTooltip : public QWidget
 {
 public:
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Defines how the tooltip fades in and out.
+    /// \enum FadeMode
+    ///
+    /// PaintFade repaints the entire tooltip for every animation frame.
+    /// LayerFade renders the contents once and only animates the opacity,
+    /// either via the window opacity (if the platform composites windows) or
+    /// by blitting the cached layer.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    enum FadeMode
+    {
+        PaintFade,
+        LayerFade
+    };
+
     OffDeclareCtor(OfficeTooltip)
     OffDefaultDtor(OfficeTooltip)
     OffDisableCopy(OfficeTooltip)
@@ -130,6 +166,14 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     int waitPeriod() const;
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the way this tooltip fades in and out.
+    ///
+    /// \return The fade mode. Defaults to OfficeTooltip::LayerFade.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    FadeMode fadeMode() const;
+
     ////////////////////////////////////////////////////////////////////////////
     /// Specifies the title of this tooltip.
     ///
@@ -194,6 +238,14 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     void setWaitPeriod(int milliseconds);
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the way this tooltip fades in and out.
+    ///
+    /// \param[in] mode The new fade mode.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setFadeMode(FadeMode mode);
+
 protected:
 
     virtual void paintEvent(QPaintEvent*) override;
@@ -219,7 +271,12 @@ public slots:
 private:
 
     void updateRectangles();
-    void generateDropShadow();
+    void applyLayout(const priv::TooltipLayout&);
+    void beginPrepareLayer();
+    void cancelPrepareLayer();
+    bool takePreparedLayer();
+    void paintContent(QPainter&);
+    void renderLayer();
     qreal opacity() const;
     void setOpacity(qreal opacity);
 
@@ -232,20 +289,19 @@ private:
     QString             m_bodyText;
     QString             m_helpText;
     QPixmap             m_helpIcon;
+    QImage              m_helpImage;
     qint32              m_duration;
     qint32              m_waitPeriod;
     Qt::Key             m_helpKey;
-    QPixmap             m_dropShadow;
-    QRect               m_clientRectangle;
-    QRect               m_borderRectangle;
-    QRect               m_headingRectangle;
-    QRect               m_bodyRectangle;
-    QRect               m_iconRectangle;
-    QRect               m_helpRectangle;
-    QRect               m_sepaRectangle;
+    QPixmap             m_contentLayer;
+    FadeMode            m_fadeMode;
+    priv::TooltipLayout m_layout;
+    std::shared_ptr<priv::TooltipJob> m_job;
     qreal               m_opacity;
     bool                m_isHelpEnabled;
     bool                m_isLinkHovered;
+    bool                m_isLayerDirty;
+    bool                m_useWindowOpacity;
 
     Q_OBJECT
     Q_PROPERTY(qreal Opacity READ opacity WRITE setOpacity)
@@ -0,0 +1,179 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// QOffice - The office framework for Qt
+// Copyright (C) 2016-2018 Nicolas Kogler
+//
+// This file is part of the Widget module.
+//
+// QOffice is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// QOffice is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with QOffice. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#ifndef QOFFICE_WIDGETS_OFFICETOOLTIPMANAGER_HPP
+#define QOFFICE_WIDGETS_OFFICETOOLTIPMANAGER_HPP
+
+#include <QOffice/Config.hpp>
+#include <QPixmap>
+#include <QPointer>
+
+class OfficeTooltip;
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class OfficeTooltipContent
+/// \ingroup Widget
+///
+/// \brief Describes what a tooltip shows on behalf of a requester.
+///
+/// Widgets that want to show tooltips keep nothing but this lightweight
+/// descriptor and pass it to OfficeTooltipManager::show. A null help icon
+/// selects the default help icon.
+///
+////////////////////////////////////////////////////////////////////////////////
+struct QOFFICE_WIDGET_API OfficeTooltipContent
+{
+    OfficeTooltipContent();
+
+    QString title;
+    QString text;
+    QString helpText;
+    QPixmap helpIcon;
+    Qt::Key helpKey;
+    bool    helpEnabled;
+    int     duration;
+    int     waitPeriod;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class OfficeTooltipManager
+/// \ingroup Widget
+///
+/// \brief Shows tooltips for any number of widgets in one native window.
+///
+/// Only one tooltip is ever visible at a time, hence all requesters share one
+/// pooled OfficeTooltip. The window is created the first time a tooltip is
+/// shown and destroyed once the last user released the manager:
+///
+/// \code
+/// OfficeTooltipManager::instance()->acquire(); // e.g. in the constructor
+///
+/// OfficeTooltipContent content;
+/// content.title = "Open";
+/// content.text = "Opens an existing file with read-write access.";
+/// OfficeTooltipManager::instance()->show(this, content, geometry);
+///
+/// OfficeTooltipManager::instance()->release(); // e.g. in the destructor
+/// \endcode
+///
+/// Showing the tooltip for another requester takes it away from the previous
+/// one. Hiding it only succeeds for the requester it is currently shown for.
+///
+////////////////////////////////////////////////////////////////////////////////
+class QOFFICE_WIDGET_API OfficeTooltipManager : public QObject
+{
+public:
+
+    OffDeclareDtor(OfficeTooltipManager)
+    OffDisableCopy(OfficeTooltipManager)
+    OffDisableMove(OfficeTooltipManager)
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the tooltip manager of the application.
+    ///
+    /// \return The one and only tooltip manager.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    static OfficeTooltipManager* instance();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Registers a user of the pooled tooltip window.
+    ///
+    /// \sa OfficeTooltipManager::release
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void acquire();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Unregisters a user of the pooled tooltip window. The window is destroyed
+    /// as soon as there are no more users.
+    ///
+    /// \sa OfficeTooltipManager::acquire
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void release();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Shows a tooltip on behalf of \p requester.
+    ///
+    /// \param[in] requester The object the tooltip is shown for.
+    /// \param[in] content The contents of the tooltip.
+    /// \param[in] geometry The global geometry of the tooltip. The height is
+    ///            adjusted to the contents.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void show(QObject* requester, const OfficeTooltipContent& content, const QRect& geometry);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Hides the tooltip if it is currently shown for \p requester.
+    ///
+    /// \param[in] requester The object the tooltip was shown for.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void hide(QObject* requester);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether the tooltip is currently shown for \p requester.
+    ///
+    /// \param[in] requester The object to check.
+    /// \return True if the tooltip belongs to \p requester, false otherwise.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool isShownFor(QObject* requester) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the global geometry of the visible tooltip.
+    ///
+    /// \return The geometry, or an invalid rectangle if no tooltip is shown.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    QRect geometry() const;
+
+signals:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// This signal is emitted once the user requests help for a tooltip.
+    ///
+    /// \param[in] requester The object the tooltip was shown for.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void helpRequested(QObject* requester);
+
+private slots:
+
+    void onHelpRequested();
+    void onAboutToQuit();
+
+private:
+
+    OffDeclareCtor(OfficeTooltipManager)
+
+    QPointer<OfficeTooltip> m_tooltip;
+    QPointer<QObject>       m_requester;
+    QPixmap                 m_defaultHelpIcon;
+    int                     m_users;
+
+    Q_OBJECT
+};
+
+#endif
@@ -26,7 +26,6 @@
 
 #include <QOffice/Widgets/OfficeWindowMenuItem.hpp>
 
-class OfficeTooltip;
 class OfficeWindow;
 
 namespace priv { class Titlebar; }
@@ -163,7 +162,7 @@ protected:
 private slots:
 
     void onItemClicked(priv::WindowItem*);
-    void onHelpRequested();
+    void onHelpRequested(QObject*);
     void onShowTooltip(priv::WindowItem*);
     void onHideTooltip(priv::WindowItem*);
     bool addItem(
@@ -178,7 +177,6 @@ private:
     Type                     m_type;
     QList<priv::WindowItem*> m_items;
     OfficeWindow*            m_parent;
-    OfficeTooltip*           m_tooltip;
 
     friend class priv::WindowItem;
     friend class OfficeWindow;
@@ -28,6 +28,55 @@
 #include <QImage>
 #include <QPainter>
 #include <QPixmap>
+#include <QVector>
+
+static void blurAlpha(QImage& image, int radius)
+{
+    const int imgWidth = image.width();
+    const int imgHeight = image.height();
+    const int diameter = radius * 2 + 1;
+
+    QVector<int> alpha(qMax(imgWidth, imgHeight));
+
+    // Slides a box of the given radius over one row or column. The shadow is
+    // black, thus only the alpha channel of the premultiplied pixel is set.
+    auto blurLine = [&](QRgb* first, int count, int stride)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            alpha[i] = qAlpha(first[i * stride]);
+        }
+
+        int sum = 0;
+        for (int i = 0; i <= radius && i < count; i++)
+        {
+            sum += alpha[i];
+        }
+
+        for (int i = 0; i < count; i++)
+        {
+            first[i * stride] = qRgba(0, 0, 0, sum / diameter);
+
+            if (i + radius + 1 < count) sum += alpha[i + radius + 1];
+            if (i - radius >= 0) sum -= alpha[i - radius];
+        }
+    };
+
+    // Three passes of a box blur closely approximate a gaussian blur.
+    for (int pass = 0; pass < 3; pass++)
+    {
+        for (int y = 0; y < imgHeight; y++)
+        {
+            blurLine(reinterpret_cast<QRgb*>(image.scanLine(y)), imgWidth, 1);
+        }
+
+        const int stride = image.bytesPerLine() / 4;
+        for (int x = 0; x < imgWidth; x++)
+        {
+            blurLine(reinterpret_cast<QRgb*>(image.bits()) + x, imgHeight, stride);
+        }
+    }
+}
 
 QImage OfficeImage::convertToGrayscale(const QImage& original)
 {
@@ -64,6 +113,8 @@ QPixmap OfficeImage::convertToGrayscale(const QPixmap& original)
 
 QPixmap OfficeImage::generateDropShadow(const QSize& size)
 {
+    OffTraceScope("OfficeImage::generateDropShadow");
+
     QPixmap result(size);
     result.fill(Qt::transparent);
 
@@ -94,3 +145,39 @@ QPixmap OfficeImage::generateDropShadow(const QSize& size)
 
     return result;
 }
+
+QImage OfficeImage::generateDropShadowImage(const QSize& size)
+{
+    OffTraceScope("OfficeImage::generateDropShadowImage");
+
+    QImage shape(size, QImage::Format_ARGB32_Premultiplied);
+    shape.fill(Qt::transparent);
+
+    QPainter painter(&shape);
+    QPainterPath path;
+    QRectF roundedRect(
+        c_shadowPadding,
+        c_shadowPadding,
+        size.width()  - c_shadowPadding * 2,
+        size.height() - c_shadowPadding * 2
+        );
+
+    path.addRoundedRect(roundedRect, 4, 4);
+    painter.fillPath(path, Qt::black);
+    painter.end();
+
+    // Mirrors OfficeImage::generateDropShadow: the blurred shape, offset by
+    // the shadow offset, with the sharp shape on top of it.
+    QImage blurred = shape.copy();
+    blurAlpha(blurred, c_shadowSize);
+
+    QImage result(size, QImage::Format_ARGB32_Premultiplied);
+    result.fill(Qt::transparent);
+
+    painter.begin(&result);
+    painter.drawImage(QPoint(c_shadowBlur, c_shadowBlur), blurred);
+    painter.drawImage(QPoint(), shape);
+    painter.end();
+
+    return result;
+}
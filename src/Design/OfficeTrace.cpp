@@ -0,0 +1,284 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// QOffice - The office framework for Qt
+// Copyright (C) 2016-2018 Nicolas Kogler
+//
+// This file is part of the Design module.
+//
+// QOffice is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// QOffice is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with QOffice. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QOffice/Config.hpp>
+
+#if defined(QOFFICE_ENABLE_TRACING)
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QMutex>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+// Must be a power of two; the write index is wrapped with a bit mask.
+static QOFFICE_CONSTEXPR quint64 c_traceCapacity = 16384;
+static QOFFICE_CONSTEXPR quint64 c_traceMask = c_traceCapacity - 1;
+
+// A slot is guarded by a sequence lock: the sequence is odd while the owning
+// thread writes the slot and 2 * (index + 1) once event #index is complete.
+// The dump skips slots whose sequence is odd or changed while reading them.
+struct TraceEvent
+{
+    std::atomic<quint64>     sequence;
+    std::atomic<const char*> name;
+    std::atomic<qint64>      begin;
+    std::atomic<qint64>      end;
+};
+
+struct TraceBuffer
+{
+    TraceEvent           events[c_traceCapacity];
+    std::atomic<quint64> written;
+    int                  threadId;
+};
+
+struct RetiredEvent
+{
+    const char* name;
+    qint64      begin;
+    qint64      end;
+    int         threadId;
+};
+
+// Every thread writes into its own buffer without any locking. The mutex
+// guards the registration and recycling of buffers and the dump.
+static QMutex g_traceMutex;
+static std::vector<std::unique_ptr<TraceBuffer>> g_traceBuffers;
+static std::vector<TraceBuffer*> g_activeBuffers;
+static std::vector<TraceBuffer*> g_freeBuffers;
+static std::vector<RetiredEvent> g_retiredEvents;
+static quint64 g_retiredWritten = 0;
+static int g_nextThreadId = 1;
+
+static void resetBuffer(TraceBuffer* buffer)
+{
+    for (auto& event : buffer->events)
+    {
+        event.sequence.store(0, std::memory_order_relaxed);
+    }
+
+    buffer->written.store(0, std::memory_order_relaxed);
+    buffer->threadId = g_nextThreadId++;
+}
+
+static void retireBuffer(TraceBuffer* buffer)
+{
+    QMutexLocker lock(&g_traceMutex);
+
+    // The thread is exiting, hence nothing writes the buffer anymore. Its
+    // events move into one shared ring, so that threads that come and go
+    // (e.g. those of a thread pool) do not grow the memory without bound.
+    if (g_retiredEvents.empty())
+    {
+        g_retiredEvents.resize(c_traceCapacity);
+    }
+
+    const quint64 written = buffer->written.load(std::memory_order_relaxed);
+    const quint64 count = qMin(written, c_traceCapacity);
+
+    for (quint64 i = written - count; i < written; i++)
+    {
+        const TraceEvent& event = buffer->events[i & c_traceMask];
+        RetiredEvent& retired = g_retiredEvents[g_retiredWritten++ & c_traceMask];
+
+        retired.name = event.name.load(std::memory_order_relaxed);
+        retired.begin = event.begin.load(std::memory_order_relaxed);
+        retired.end = event.end.load(std::memory_order_relaxed);
+        retired.threadId = buffer->threadId;
+    }
+
+    g_activeBuffers.erase(std::find(g_activeBuffers.begin(), g_activeBuffers.end(), buffer));
+    g_freeBuffers.push_back(buffer);
+}
+
+// Hands the buffer back once its thread exits.
+struct ThreadBuffer
+{
+    TraceBuffer* buffer = nullptr;
+
+    ~ThreadBuffer()
+    {
+        if (buffer != nullptr)
+        {
+            retireBuffer(buffer);
+        }
+    }
+};
+
+static thread_local ThreadBuffer g_threadBuffer;
+
+static TraceBuffer* threadBuffer()
+{
+    if (g_threadBuffer.buffer == nullptr)
+    {
+        QMutexLocker lock(&g_traceMutex);
+
+        if (g_freeBuffers.empty())
+        {
+            g_traceBuffers.emplace_back(new TraceBuffer());
+            g_freeBuffers.push_back(g_traceBuffers.back().get());
+        }
+
+        TraceBuffer* buffer = g_freeBuffers.back();
+        g_freeBuffers.pop_back();
+        resetBuffer(buffer);
+
+        g_activeBuffers.push_back(buffer);
+        g_threadBuffer.buffer = buffer;
+    }
+
+    return g_threadBuffer.buffer;
+}
+
+static void appendEscaped(QByteArray& json, const char* text)
+{
+    for (; *text != '\0'; text++)
+    {
+        if (*text == '"' || *text == '\\')
+        {
+            json.append('\\');
+        }
+
+        json.append(*text);
+    }
+}
+
+static QByteArray toMicroseconds(qint64 nanoseconds)
+{
+    return QByteArray::number(nanoseconds / 1000.0, 'f', 3);
+}
+
+static void appendEvent(
+    QByteArray& json,
+    bool& isFirst,
+    const QByteArray& pid,
+    int threadId,
+    const char* name,
+    qint64 begin,
+    qint64 end
+    )
+{
+    json.append(isFirst ? "\n" : ",\n");
+    json.append("{\"name\":\"");
+    appendEscaped(json, name);
+    json.append("\",\"cat\":\"qoffice\",\"ph\":\"X\",\"ts\":");
+    json.append(toMicroseconds(begin));
+    json.append(",\"dur\":");
+    json.append(toMicroseconds(end - begin));
+    json.append(",\"pid\":");
+    json.append(pid);
+    json.append(",\"tid\":");
+    json.append(QByteArray::number(threadId));
+    json.append('}');
+
+    isFirst = false;
+}
+
+qint64 QOfficeTraceNow()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void QOfficeTraceRecord(const char* name, qint64 begin, qint64 end)
+{
+    TraceBuffer* buffer = threadBuffer();
+
+    // The oldest events are overwritten once the ring buffer is full. Only
+    // the owning thread advances the index, so a relaxed load suffices.
+    const quint64 index = buffer->written.load(std::memory_order_relaxed);
+    TraceEvent& event = buffer->events[index & c_traceMask];
+
+    event.sequence.store(index * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    event.name.store(name, std::memory_order_relaxed);
+    event.begin.store(begin, std::memory_order_relaxed);
+    event.end.store(end, std::memory_order_relaxed);
+
+    event.sequence.store(index * 2 + 2, std::memory_order_release);
+    buffer->written.store(index + 1, std::memory_order_release);
+}
+
+bool QOfficeTraceDump(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        return false;
+    }
+
+    const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+    QByteArray json("{\"traceEvents\":[");
+    bool isFirst = true;
+
+    QMutexLocker lock(&g_traceMutex);
+
+    const quint64 retiredCount = qMin(g_retiredWritten, c_traceCapacity);
+    for (quint64 i = g_retiredWritten - retiredCount; i < g_retiredWritten; i++)
+    {
+        const RetiredEvent& event = g_retiredEvents[i & c_traceMask];
+        appendEvent(json, isFirst, pid, event.threadId, event.name, event.begin, event.end);
+    }
+
+    for (const TraceBuffer* buffer : g_activeBuffers)
+    {
+        // Threads keep on recording while dumping. A slot that is written or
+        // already holds a newer event while it is read is skipped.
+        const quint64 written = buffer->written.load(std::memory_order_acquire);
+        const quint64 count = qMin(written, c_traceCapacity);
+
+        for (quint64 i = written - count; i < written; i++)
+        {
+            const TraceEvent& event = buffer->events[i & c_traceMask];
+            const quint64 sequence = event.sequence.load(std::memory_order_acquire);
+
+            if (sequence != i * 2 + 2)
+            {
+                continue;
+            }
+
+            const char* name = event.name.load(std::memory_order_relaxed);
+            const qint64 begin = event.begin.load(std::memory_order_relaxed);
+            const qint64 end = event.end.load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (event.sequence.load(std::memory_order_relaxed) != sequence)
+            {
+                continue;
+            }
+
+            appendEvent(json, isFirst, pid, buffer->threadId, name, begin, end);
+        }
+    }
+
+    json.append("\n],\"displayTimeUnit\":\"ms\"}\n");
+
+    return file.write(json) == json.size();
+}
+
+#endif
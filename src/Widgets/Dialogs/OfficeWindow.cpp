@@ -25,6 +25,8 @@
 #include <QOffice/Design/OfficePalette.hpp>
 #include <QOffice/Widgets/Dialogs/OfficeWindow.hpp>
 
+#include <QApplication>
+#include <QDesktopWidget>
 #include <QLayout>
 #include <QPainter>
 #include <QtEvents>
@@ -137,6 +139,8 @@ void OfficeWindow::setCloseButtonVisible(bool visible)
     {
         OffAddFlag(m_flagsWindow, NoCloseButton);
     }
+
+    updateChrome();
 }
 
 void OfficeWindow::setMaximizeButtonVisible(bool visible)
@@ -149,6 +153,8 @@ void OfficeWindow::setMaximizeButtonVisible(bool visible)
     {
         OffAddFlag(m_flagsWindow, NoMaximizeButton);
     }
+
+    updateChrome();
 }
 
 void OfficeWindow::setMinimizeButtonVisible(bool visible)
@@ -161,6 +167,8 @@ void OfficeWindow::setMinimizeButtonVisible(bool visible)
     {
         OffAddFlag(m_flagsWindow, NoMinimizeButton);
     }
+
+    updateChrome();
 }
 
 void OfficeWindow::setResizable(bool resizable)
@@ -173,11 +181,15 @@ void OfficeWindow::setResizable(bool resizable)
     {
         OffAddFlag(m_flagsWindow, NoResize);
     }
+
+    updateChrome();
 }
 
 void OfficeWindow::setFlags(Flags flags)
 {
     m_flagsWindow = flags;
+
+    updateChrome();
 }
 
 OfficeWindow* OfficeWindow::activeWindow()
@@ -192,6 +204,8 @@ void OfficeWindow::accentUpdateEvent()
 
 void OfficeWindow::paintEvent(QPaintEvent*)
 {
+    OffTraceScope("OfficeWindow::paint");
+
     QPainter painter(this);
 
     // Retrieves various standardized QOffice colors.
@@ -223,13 +237,18 @@ void OfficeWindow::paintEvent(QPaintEvent*)
 
 void OfficeWindow::resizeEvent(QResizeEvent* event)
 {
-    updateResizeRectangles();
-    updateLayoutPadding();
+    OffTraceScope("OfficeWindow::resize");
+
+    // Maximizing or restoring the window only swaps the layout that was
+    // prepared in advance; the new size is the only thing recalculated.
+    prepareChromeLayouts();
+    applyChromeLayout(chromeMode());
     updateResizeWidgets();
 
     // Does not generate a drop shadow if resizing or currently being in
-    // maximized window mode.
-    if (m_stateWindow != StateResize && !isMaximized())
+    // maximized window mode. The shadow solely depends on the window size,
+    // hence restoring the window reuses the one generated before.
+    if (m_stateWindow != StateResize && !isMaximized() && m_dropShadow.size() != size())
     {
         // Little hack: When the window is really big, repainting the drop
         // shadow takes long, causing layouts, button rectangles and other
@@ -268,12 +287,23 @@ void OfficeWindow::showEvent(QShowEvent* event)
 {
     // When window is first shown, apply accent color to all widgets.
     setAccent(accent());
-    updateLayoutPadding();
-    updateResizeRectangles();
+    updateChrome();
 
     QWidget::showEvent(event);
 }
 
+void OfficeWindow::changeEvent(QEvent* event)
+{
+    if (event->type() == QEvent::WindowTitleChange)
+    {
+        // The elided title is part of the prepared layouts.
+        updateChrome();
+        m_titleBar->update();
+    }
+
+    QWidget::changeEvent(event);
+}
+
 bool OfficeWindow::event(QEvent* event)
 {
     switch (event->type())
@@ -297,36 +327,12 @@ void OfficeWindow::generateDropShadow()
     m_dropShadow = OfficeImage::generateDropShadow(size());
 }
 
-void OfficeWindow::updateResizeRectangles()
+void OfficeWindow::updateChrome()
 {
-    int padding  = (isMaximized()) ? 0 : c_shadowPadding;
-
-    // Resize areas
-    m_resizeTopLeft->setGeometry(0, 0, 10, 10);
-    m_resizeTopRight->setGeometry(width() - 10, 0, 10, 10);
-    m_resizeBottomRight->setGeometry(width() - 10, height() - 10, 10, 10);
-    m_resizeBottomLeft->setGeometry(0, height() - 10, 10, 10);
-    m_resizeTop->setGeometry(10, 0, width() - 20, 10);
-    m_resizeRight->setGeometry(width() - 10, 10, 10, height() - 20);
-    m_resizeBottom->setGeometry(10, height() - 10, width() - 20, 10);
-    m_resizeLeft->setGeometry(0, 10, 10, height() - 20);
-
-    m_clientRectangle.setRect(
-        padding,
-        padding,
-        width()  - padding * 2,
-        height() - padding * 2
-        );
-
-    m_titleBar->setGeometry(
-        padding + 1,
-        padding + 1,
-        width() - padding * 2 - 2,
-        c_titleHeight - 1
-        );
-
-    m_titleBar->updateRectangles();
-    m_titleBar->updateVisibleTitle();
+    prepareChromeLayouts();
+    applyChromeLayout(chromeMode());
+    updateResizeWidgets();
+    update();
 }
 
 void OfficeWindow::updateResizeWidgets()
@@ -355,18 +361,49 @@ void OfficeWindow::updateResizeWidgets()
     }
 }
 
-void OfficeWindow::updateLayoutPadding()
+void OfficeWindow::prepareChromeLayouts()
 {
-    if (layout() != nullptr)
+    OffTraceScope("OfficeWindow::layout");
+
+    // The maximized layout is prepared for the screen the window resides on,
+    // the normal one for the geometry the window is restored to.
+    const QSize normalSize = (isMaximized()) ? normalGeometry().size() : size();
+    const QSize maximizedSize = QApplication::desktop()->availableGeometry(this).size();
+
+    prepareChromeLayout(priv::Titlebar::NormalLayout, normalSize);
+    prepareChromeLayout(priv::Titlebar::MaximizedLayout, maximizedSize);
+}
+
+void OfficeWindow::prepareChromeLayout(priv::Titlebar::LayoutMode mode, const QSize& size)
+{
+    ChromeLayout& chrome = m_chromeLayouts[mode];
+    int padding = (mode == priv::Titlebar::MaximizedLayout) ? 0 : c_shadowPadding;
+
+    if (chrome.size != size)
     {
-        if (isMaximized())
+        chrome.size = size;
+        chrome.clientRectangle.setRect(
+            padding,
+            padding,
+            size.width()  - padding * 2,
+            size.height() - padding * 2
+            );
+
+        chrome.titleRectangle.setRect(
+            padding + 1,
+            padding + 1,
+            size.width() - padding * 2 - 2,
+            c_titleHeight - 1
+            );
+
+        if (mode == priv::Titlebar::MaximizedLayout)
         {
             // No drop shadow in maximize mode.
-            layout()->setContentsMargins(1, c_titleHeight, 1, 1);
+            chrome.layoutMargins = QMargins(1, c_titleHeight, 1, 1);
         }
         else
         {
-            layout()->setContentsMargins(
+            chrome.layoutMargins = QMargins(
                 c_shadowPadding + 1,
                 c_titleHeight + c_shadowPadding,
                 c_shadowPadding + 1,
@@ -374,6 +411,39 @@ void OfficeWindow::updateLayoutPadding()
                 );
         }
     }
+
+    // The titlebar additionally depends on the title and the flags; it does
+    // nothing if neither of them changed.
+    m_titleBar->prepareLayout(mode, chrome.titleRectangle.size());
+}
+
+void OfficeWindow::applyChromeLayout(priv::Titlebar::LayoutMode mode)
+{
+    const ChromeLayout& chrome = m_chromeLayouts[mode];
+
+    // Resize areas
+    m_resizeTopLeft->setGeometry(0, 0, 10, 10);
+    m_resizeTopRight->setGeometry(width() - 10, 0, 10, 10);
+    m_resizeBottomRight->setGeometry(width() - 10, height() - 10, 10, 10);
+    m_resizeBottomLeft->setGeometry(0, height() - 10, 10, 10);
+    m_resizeTop->setGeometry(10, 0, width() - 20, 10);
+    m_resizeRight->setGeometry(width() - 10, 10, 10, height() - 20);
+    m_resizeBottom->setGeometry(10, height() - 10, width() - 20, 10);
+    m_resizeLeft->setGeometry(0, 10, 10, height() - 20);
+
+    m_clientRectangle = chrome.clientRectangle;
+    m_titleBar->setGeometry(chrome.titleRectangle);
+    m_titleBar->applyLayout(mode);
+
+    if (layout() != nullptr)
+    {
+        layout()->setContentsMargins(chrome.layoutMargins);
+    }
+}
+
+priv::Titlebar::LayoutMode OfficeWindow::chromeMode() const
+{
+    return (isMaximized()) ? priv::Titlebar::MaximizedLayout : priv::Titlebar::NormalLayout;
 }
 
 bool OfficeWindow::isActive() const
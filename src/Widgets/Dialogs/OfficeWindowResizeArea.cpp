@@ -73,13 +73,9 @@ void priv::ResizeArea::enterEvent(QEvent*)
 {
     if (m_window != nullptr)
     {
-        // When entering a resize area, no button should be highlighted.
-        m_window->m_titleBar->m_stateClose    = priv::Titlebar::ButtonNone;
-        m_window->m_titleBar->m_stateMaximize = priv::Titlebar::ButtonNone;
-        m_window->m_titleBar->m_stateMinimize = priv::Titlebar::ButtonNone;
-
-        // Applies the changes we just did visually.
-        m_window->m_titleBar->update();
+        // When entering a resize area, no button should be highlighted. Only
+        // the buttons that were highlighted before will be repainted.
+        m_window->m_titleBar->resetButtons();
     }
 }
 
@@ -34,76 +34,99 @@ static QOFFICE_CONSTEXPR int c_titlePaddingY = 10;
 static QOFFICE_CONSTEXPR int c_windowButtonX = 10;
 static QOFFICE_CONSTEXPR int c_windowButtonY = 8;
 
+static QOFFICE_CONSTEXPR priv::Titlebar::ButtonState c_none    = priv::Titlebar::ButtonNone;
+static QOFFICE_CONSTEXPR priv::Titlebar::ButtonState c_hover   = priv::Titlebar::ButtonHover;
+static QOFFICE_CONSTEXPR priv::Titlebar::ButtonState c_press   = priv::Titlebar::ButtonPress;
+static QOFFICE_CONSTEXPR priv::Titlebar::ButtonState c_special = priv::Titlebar::ButtonSpecial;
+
+// The flag that hides the button, indexed by priv::Titlebar::Button.
+static QOFFICE_CONSTEXPR OfficeWindow::Flags c_buttonFlags[priv::Titlebar::ButtonCount] =
+{
+    OfficeWindow::NoCloseButton,
+    OfficeWindow::NoMaximizeButton,
+    OfficeWindow::NoMinimizeButton
+};
+
+// The next state of a button, indexed by [event][current state][is hit]. A
+// button is "special" while it is pressed but the mouse pointer is outside.
+static QOFFICE_CONSTEXPR priv::Titlebar::ButtonState
+c_buttonTransitions[priv::Titlebar::ButtonEventCount][priv::Titlebar::ButtonStateCount][2] =
+{
+    // EventMove: the hover state follows the mouse pointer.
+    {
+        { c_none,    c_hover },
+        { c_none,    c_hover },
+        { c_special, c_press },
+        { c_special, c_press }
+    },
+    // EventCapturedMove: only the pressed button toggles press <> special.
+    {
+        { c_none,    c_none  },
+        { c_none,    c_none  },
+        { c_special, c_press },
+        { c_special, c_press }
+    },
+    // EventPress
+    {
+        { c_none,    c_press },
+        { c_none,    c_press },
+        { c_none,    c_press },
+        { c_none,    c_press }
+    },
+    // EventRelease
+    {
+        { c_none,    c_none  },
+        { c_none,    c_none  },
+        { c_none,    c_none  },
+        { c_none,    c_none  }
+    },
+    // EventLeave
+    {
+        { c_none,    c_none  },
+        { c_none,    c_none  },
+        { c_none,    c_none  },
+        { c_none,    c_none  }
+    }
+};
+
 priv::Titlebar::Titlebar(OfficeWindow* window)
     : QWidget(window)
     , m_window(window)
     , m_windowLabelMenu(new OfficeWindowMenu(this, OfficeWindowMenu::LabelMenu))
     , m_windowQuickMenu(new OfficeWindowMenu(this, OfficeWindowMenu::QuickMenu))
-    , m_stateClose(ButtonNone)
-    , m_stateMaximize(ButtonNone)
-    , m_stateMinimize(ButtonNone)
+    , m_buttonStates()
     , m_imageClose(QPixmap(":/qoffice/images/window/close.png"))
     , m_imageMaximize(QPixmap(":/qoffice/images/window/max.png"))
     , m_imageMinimize(QPixmap(":/qoffice/images/window/min.png"))
     , m_imageRestore(QPixmap(":/qoffice/images/window/restore.png"))
+    , m_layouts()
+    , m_layout(&m_layouts[NormalLayout])
 {
     setMouseTracking(true);
 }
 
 void priv::Titlebar::paintEvent(QPaintEvent*)
 {
+    OffTraceScope("Titlebar::paint");
+
     QPainter painter(this);
-    Office::Accent accent = m_window->accent();
 
-    // Background
-    painter.fillRect(m_titleRectangle, OfficeAccent::color(accent));
+    // Background, title text and button icons only change with the accent,
+    // the activation state, the size or the visible title. They are rendered
+    // once into a layer; the painter is clipped to the invalidated region, so
+    // hovering a button merely blits that button's rectangle.
+    updateStaticLayer();
+    painter.drawPixmap(QPoint(), m_staticLayer);
 
-    // Titlebar text
     if (!m_window->isActive())
     {
-        // When the window is not active, the titlebar text and the titlebar
-        // buttons should not be rendered darker but rather blend into the
-        // background.
         painter.setOpacity(0.5);
     }
 
-    painter.setFont(font());
-    painter.setPen(OfficePalette::color(OfficePalette::Background));
-    painter.drawText(m_titleRectangle, m_visibleTitle, QTextOption(Qt::AlignCenter));
-
-    // Window button background
-    if (m_stateClose == ButtonHover)
-        painter.fillRect(m_closeRectangle, OfficeAccent::lightColor(accent));
-    else if (m_stateMaximize == ButtonHover)
-        painter.fillRect(m_maximizeRectangle, OfficeAccent::lightColor(accent));
-    else if (m_stateMinimize == ButtonHover)
-        painter.fillRect(m_minimizeRectangle, OfficeAccent::lightColor(accent));
-    else if (m_stateClose == ButtonPress)
-        painter.fillRect(m_closeRectangle, OfficeAccent::darkColor(accent));
-    else if (m_stateMaximize == ButtonPress)
-        painter.fillRect(m_maximizeRectangle, OfficeAccent::darkColor(accent));
-    else if (m_stateMinimize == ButtonPress)
-        painter.fillRect(m_minimizeRectangle, OfficeAccent::darkColor(accent));
-
-    // Window button icons
-    if (OffHasNotFlag(m_window->m_flagsWindow, OfficeWindow::NoCloseButton))
+    // Window button overlays
+    for (int i = 0; i < ButtonCount; i++)
     {
-        painter.drawPixmap(centerRectangle(m_imageClose, m_closeRectangle), m_imageClose);
-    }
-    if (OffHasNotFlag(m_window->m_flagsWindow, OfficeWindow::NoMinimizeButton))
-    {
-        painter.drawPixmap(centerRectangle(m_imageMinimize, m_minimizeRectangle), m_imageMinimize);
-    }
-    if (OffHasNotFlag(m_window->m_flagsWindow, OfficeWindow::NoMaximizeButton))
-    {
-        if (m_window->isMaximized())
-        {
-            painter.drawPixmap(centerRectangle(m_imageRestore, m_maximizeRectangle), m_imageRestore);
-        }
-        else
-        {
-            painter.drawPixmap(centerRectangle(m_imageMaximize, m_maximizeRectangle), m_imageMaximize);
-        }
+        paintButton(painter, static_cast<Button>(i));
     }
 }
 
@@ -111,14 +134,10 @@ void priv::Titlebar::mouseMoveEvent(QMouseEvent* event)
 {
     const QPoint pos = event->pos();
 
-    // Performs several hit-tests. If one of these functions returns true,
-    // the title bar will be redrawn.
+    // Runs a single hit-test and redraws the buttons that changed their state.
     if (!mouseMoveDrag(pos))
     {
-        if (mouseMoveSpecial(pos) || mouseMoveHitTest(pos))
-        {
-            update();
-        }
+        update(transition(EventMove, pos));
     }
 
     QWidget::mouseMoveEvent(event);
@@ -134,10 +153,7 @@ void priv::Titlebar::mousePressEvent(QMouseEvent* event)
             return;
         }
 
-        if (mousePressHitTest(pos))
-        {
-            update();
-        }
+        update(transition(EventPress, pos));
     }
 
     QWidget::mousePressEvent(event);
@@ -153,10 +169,9 @@ void priv::Titlebar::mouseReleaseEvent(QMouseEvent* event)
             return;
         }
 
-        if (mouseReleaseAction(pos))
-        {
-            update();
-        }
+        Button triggered;
+        update(transition(EventRelease, pos, &triggered));
+        mouseReleaseAction(triggered);
     }
 
     QWidget::mouseReleaseEvent(event);
@@ -165,32 +180,12 @@ void priv::Titlebar::mouseReleaseEvent(QMouseEvent* event)
 void priv::Titlebar::mouseDoubleClickEvent(QMouseEvent* event)
 {
     if (event->button() == Qt::LeftButton &&
-        m_dragRectangle.contains(event->pos()) &&
+        m_layout->dragRectangle.contains(event->pos()) &&
         m_window->hasMaximizeButton() &&
         m_window->canResize())
     {
-        // The window is about to be maximized or restored. In order to
-        // avoid that all the titlebar's contents are invisible for a split
-        // second, we recalculate all the necessary things beforehand.
-        updateRectangles();
-        updateVisibleTitle();
-        m_window->updateResizeRectangles();
-
-        if (m_window->isMaximized())
-        {
-            m_window->showNormal();
-        }
-        else
-        {
-            m_window->showMaximized();
-        }
-
-        m_stateMaximize = ButtonNone;
-        m_window->update();
-        update();
+        toggleMaximized();
     }
-
-    m_window->updateLayoutPadding();
 }
 
 void priv::Titlebar::leaveEvent(QEvent* event)
@@ -203,41 +198,86 @@ void priv::Titlebar::leaveEvent(QEvent* event)
     }
     else
     {
-        m_stateClose    = ButtonNone;
-        m_stateMaximize = ButtonNone;
-        m_stateMinimize = ButtonNone;
-
-        update();
+        resetButtons();
     }
 
     QWidget::leaveEvent(event);
 }
 
-void priv::Titlebar::updateRectangles()
+void priv::Titlebar::changeEvent(QEvent* event)
+{
+    if (event->type() == QEvent::FontChange || event->type() == QEvent::StyleChange)
+    {
+        // The visible titles were elided with the previous font metrics. An
+        // empty size never matches the cache key of a prepared layout.
+        for (auto& layout : m_layouts)
+        {
+            layout.size = QSize();
+        }
+
+        m_staticLayer = QPixmap();
+
+        if (m_window->m_titleBar == this)
+        {
+            m_window->updateChrome();
+        }
+    }
+
+    QWidget::changeEvent(event);
+}
+
+bool priv::Titlebar::prepareLayout(LayoutMode mode, const QSize& size)
+{
+    OffTraceScope("Titlebar::layout");
+
+    Layout& layout = m_layouts[mode];
+    const int flags = static_cast<int>(m_window->m_flagsWindow);
+    const int menuWidth = m_windowLabelMenu->width() + m_windowQuickMenu->width();
+    const QString title = m_window->windowTitle();
+
+    // Elides the title with font metrics and is therefore only recalculated
+    // if one of its inputs actually changed.
+    if (layout.size == size &&
+        layout.flags == flags &&
+        layout.menuWidth == menuWidth &&
+        layout.title == title)
+    {
+        return false;
+    }
+
+    layout.size = size;
+    layout.flags = flags;
+    layout.menuWidth = menuWidth;
+    layout.title = title;
+
+    updateRectangles(layout);
+    updateVisibleTitle(layout);
+
+    return true;
+}
+
+void priv::Titlebar::applyLayout(LayoutMode mode)
+{
+    m_layout = &m_layouts[mode];
+
+    m_windowLabelMenu->move(m_layout->dragRectangle.x() + m_layout->dragRectangle.width(), 0);
+    m_windowQuickMenu->move(0, 0);
+}
+
+void priv::Titlebar::updateRectangles(Layout& layout) const
 {
     const QSize& sizeClose = m_imageClose.size();
     const QSize& sizeMaxim = m_imageMaximize.size();
     const QSize& sizeMinim = m_imageMinimize.size();
 
     // Initial button position.
-    int initialX = width() - sizeClose.width() - c_windowButtonX;
+    int initialX = layout.size.width() - sizeClose.width() - c_windowButtonX;
     int initialY = c_windowButtonY;
 
-    int totalWidth =
-        m_closeRectangle.width()    +
-        m_maximizeRectangle.width() +
-        m_minimizeRectangle.width();
-
-    int dragWidth =
-        width()     -
-        totalWidth  -
-        m_windowLabelMenu->width() -
-        m_windowQuickMenu->width();
-
     // Close button rectangle
-    if (OffHasNotFlag(m_window->m_flagsWindow, OfficeWindow::NoCloseButton))
+    if (isButtonVisible(CloseButton))
     {
-        m_closeRectangle.setRect(
+        layout.buttonRectangles[CloseButton].setRect(
             initialX - 10,
             initialY - 8,
             sizeClose.width()  + 20,
@@ -248,9 +288,9 @@ void priv::Titlebar::updateRectangles()
     }
 
     // Maximize button rectangle
-    if (OffHasNotFlag(m_window->m_flagsWindow, OfficeWindow::NoMaximizeButton))
+    if (isButtonVisible(MaximizeButton))
     {
-        m_maximizeRectangle.setRect(
+        layout.buttonRectangles[MaximizeButton].setRect(
             initialX - 10,
             initialY - 8,
             sizeMaxim.width()  + 20,
@@ -261,9 +301,9 @@ void priv::Titlebar::updateRectangles()
     }
 
     // Minimize button rectangle
-    if (OffHasNotFlag(m_window->m_flagsWindow, OfficeWindow::NoMinimizeButton))
+    if (isButtonVisible(MinimizeButton))
     {
-        m_minimizeRectangle.setRect(
+        layout.buttonRectangles[MinimizeButton].setRect(
             initialX - 10,
             initialY - 8,
             sizeMinim.width()  + 20,
@@ -271,20 +311,36 @@ void priv::Titlebar::updateRectangles()
             );
     }
 
+    // The bounding rectangle of all buttons lets hitTest reject most mouse
+    // moves with one comparison.
+    int totalWidth = 0;
+    layout.buttonArea = QRect();
+    for (int i = 0; i < ButtonCount; i++)
+    {
+        if (isButtonVisible(static_cast<Button>(i)))
+        {
+            layout.buttonArea |= layout.buttonRectangles[i];
+            totalWidth += layout.buttonRectangles[i].width();
+        }
+    }
+
+    int dragWidth =
+        layout.size.width() -
+        totalWidth          -
+        layout.menuWidth;
+
     // Misc rectangles
-    m_dragRectangle.setRect(m_windowQuickMenu->width(), 0, dragWidth, height());
-    m_titleRectangle.setRect(0, 0, width(), height());
-    m_windowLabelMenu->move(m_dragRectangle.x() + m_dragRectangle.width(), 0);
-    m_windowQuickMenu->move(0, 0);
+    layout.dragRectangle.setRect(m_windowQuickMenu->width(), 0, dragWidth, layout.size.height());
+    layout.titleRectangle.setRect(0, 0, layout.size.width(), layout.size.height());
 }
 
-void priv::Titlebar::updateVisibleTitle()
+void priv::Titlebar::updateVisibleTitle(Layout& layout) const
 {
-    QString title = m_window->windowTitle();
+    QString title = layout.title;
     QFontMetrics metrics(font());
 
     int currentWidth = metrics.width(title);
-    int estimatedWidth = m_dragRectangle.width() - c_titlePaddingX * 2 - currentWidth;
+    int estimatedWidth = layout.dragRectangle.width() - c_titlePaddingX * 2 - currentWidth;
 
     // Removes characters as long as it does not overlap the window buttons.
     while (currentWidth > estimatedWidth && estimatedWidth > 0)
@@ -298,124 +354,216 @@ void priv::Titlebar::updateVisibleTitle()
     {
         title = "";
     }
-    else if (m_window->windowTitle().length() != title.length())
+    else if (layout.title.length() != title.length())
     {
         title.remove(title.length() - 2, 2).append("...");
     }
 
-    m_visibleTitle = title;
+    layout.visibleTitle = title;
 }
 
-bool priv::Titlebar::mouseMoveDrag(const QPoint& pos)
+void priv::Titlebar::toggleMaximized()
 {
-    if (m_window->m_stateWindow == OfficeWindow::StateDrag)
+    // Both the normal and the maximized layout are prepared in advance, so
+    // the resize event following the state change merely swaps them and the
+    // window is painted exactly once.
+    m_buttonStates[MaximizeButton] = ButtonNone;
+
+    if (m_window->isMaximized())
     {
-        auto globalPos = m_window->mapToGlobal(pos);
-        if (m_window->isMaximized())
-        {
-            m_stateMaximize = ButtonNone;
-            m_window->m_stateWindow = OfficeWindow::StateNone;
+        m_window->showNormal();
+    }
+    else
+    {
+        m_window->showMaximized();
+    }
+}
 
-            // The window is about to be restored. In order to avoid that all
-            // the titlebar's contents are invisible for a split second, we
-            // recalculate all the necessary things beforehand.
-            m_window->updateLayoutPadding();
-            m_window->updateResizeRectangles();
+void priv::Titlebar::updateStaticLayer()
+{
+    OffTraceScope("Titlebar::renderLayer");
 
-            m_window->showNormal();
-        }
-        else
+    const qreal ratio = devicePixelRatioF();
+    const LayerKey key =
+    {
+        OfficeAccent::color(m_window->accent()).rgba(),
+        static_cast<int>(m_window->m_flagsWindow),
+        m_window->isActive(),
+        m_window->isMaximized(),
+        ratio,
+        size(),
+        m_layout->visibleTitle
+    };
+
+    if (!m_staticLayer.isNull() && key == m_layerKey)
+    {
+        return;
+    }
+
+    m_layerKey = key;
+    m_staticLayer = QPixmap(size() * ratio);
+    m_staticLayer.setDevicePixelRatio(ratio);
+    m_staticLayer.fill(Qt::transparent);
+
+    if (m_staticLayer.isNull())
+    {
+        return;
+    }
+
+    QPainter painter(&m_staticLayer);
+
+    // Background
+    painter.fillRect(m_layout->titleRectangle, OfficeAccent::color(m_window->accent()));
+
+    // Titlebar text
+    if (!key.active)
+    {
+        // When the window is not active, the titlebar text and the titlebar
+        // buttons should not be rendered darker but rather blend into the
+        // background.
+        painter.setOpacity(0.5);
+    }
+
+    painter.setFont(font());
+    painter.setPen(OfficePalette::color(OfficePalette::Background));
+    painter.drawText(m_layout->titleRectangle, m_layout->visibleTitle, QTextOption(Qt::AlignCenter));
+
+    // Window button icons
+    for (int i = 0; i < ButtonCount; i++)
+    {
+        const Button button = static_cast<Button>(i);
+        if (isButtonVisible(button))
         {
-            m_window->move(globalPos - m_dragPosition);
-            m_window->updateGeometry();
+            const QPixmap& image = buttonImage(button);
+            painter.drawPixmap(centerRectangle(image, m_layout->buttonRectangles[i]), image);
         }
-
-        return true;
     }
+}
 
-    return false;
+void priv::Titlebar::resetButtons()
+{
+    update(transition(EventLeave, QPoint(-1, -1)));
 }
 
-bool priv::Titlebar::mouseMoveSpecial(const QPoint& pos)
+void priv::Titlebar::paintButton(QPainter& painter, Button button)
 {
-    // Special <> press
-    if (m_stateClose == ButtonSpecial && m_closeRectangle.contains(pos))
+    const Office::Accent accent = m_window->accent();
+    const QRect& rect = m_layout->buttonRectangles[button];
+
+    if (m_buttonStates[button] == ButtonHover)
     {
-        m_stateClose = ButtonPress;
-        return true;
+        painter.fillRect(rect, OfficeAccent::lightColor(accent));
     }
-    else if (m_stateMaximize == ButtonSpecial && m_maximizeRectangle.contains(pos))
+    else if (m_buttonStates[button] == ButtonPress)
     {
-        m_stateMaximize = ButtonPress;
-        return true;
+        painter.fillRect(rect, OfficeAccent::darkColor(accent));
     }
-    else if (m_stateMinimize == ButtonSpecial && m_minimizeRectangle.contains(pos))
+    else
     {
-        m_stateMinimize = ButtonPress;
-        return true;
+        // Idle and "special" buttons look exactly like the static layer.
+        return;
     }
 
-    // Press <> special
-    if (m_stateClose == ButtonPress && !m_closeRectangle.contains(pos))
+    // The overlay covers the icon of the static layer, so draw it again.
+    const QPixmap& image = buttonImage(button);
+    painter.drawPixmap(centerRectangle(image, rect), image);
+}
+
+bool priv::Titlebar::isButtonVisible(Button button) const
+{
+    return OffHasNotFlag(m_window->m_flagsWindow, c_buttonFlags[button]);
+}
+
+bool priv::Titlebar::isButtonCaptured() const
+{
+    for (int i = 0; i < ButtonCount; i++)
     {
-        m_stateClose = ButtonSpecial;
-        return true;
+        if (m_buttonStates[i] == ButtonPress || m_buttonStates[i] == ButtonSpecial)
+            return true;
     }
-    else if (m_stateMaximize == ButtonPress && !m_maximizeRectangle.contains(pos))
+
+    return false;
+}
+
+priv::Titlebar::Button priv::Titlebar::hitTest(const QPoint& pos) const
+{
+    if (!m_layout->buttonArea.contains(pos))
     {
-        m_stateMaximize = ButtonSpecial;
-        return true;
+        return NoButton;
     }
-    else if (m_stateMinimize == ButtonPress && !m_minimizeRectangle.contains(pos))
+
+    for (int i = 0; i < ButtonCount; i++)
     {
-        m_stateMinimize = ButtonSpecial;
-        return true;
+        const Button button = static_cast<Button>(i);
+        if (isButtonVisible(button) && m_layout->buttonRectangles[i].contains(pos))
+            return button;
     }
 
-    return false;
+    return NoButton;
 }
 
-bool priv::Titlebar::mouseMoveHitTest(const QPoint& pos)
+QRegion priv::Titlebar::transition(
+    ButtonEvent event,
+    const QPoint& pos,
+    Button* triggered
+    )
 {
-    // Changes the button into hovered state if the mouse pointer happens to
-    // hover it.
-    if (m_stateClose    != ButtonPress   &&
-        m_stateClose    != ButtonSpecial &&
-        m_stateMaximize != ButtonPress   &&
-        m_stateMaximize != ButtonSpecial &&
-        m_stateMinimize != ButtonPress   &&
-        m_stateMinimize != ButtonSpecial)
-    {
-        // Determines whether one button has been hovered before. If yes, do not
-        // perform a repaint of the title bar.
-        bool state = m_stateClose    != ButtonHover &&
-                     m_stateMaximize != ButtonHover &&
-                     m_stateMinimize != ButtonHover;
-
-        m_stateClose    = ButtonNone;
-        m_stateMaximize = ButtonNone;
-        m_stateMinimize = ButtonNone;
-
-        if (OffHasNotFlag(m_window->m_flagsWindow, OfficeWindow::NoCloseButton) &&
-            m_closeRectangle.contains(pos))
+    const Button hit = hitTest(pos);
+    QRegion dirty;
+
+    // While a button is pressed, the other buttons must not be hovered.
+    if (event == EventMove && isButtonCaptured())
+    {
+        event = EventCapturedMove;
+    }
+
+    if (triggered != nullptr)
+    {
+        *triggered = NoButton;
+    }
+
+    for (int i = 0; i < ButtonCount; i++)
+    {
+        const ButtonState current = m_buttonStates[i];
+        const ButtonState next = c_buttonTransitions[event][current][hit == i];
+
+        // A button only fires if it is released while the pointer is on it.
+        if (triggered != nullptr &&
+            event == EventRelease &&
+            current == ButtonPress &&
+            hit == i)
         {
-            m_stateClose = ButtonHover;
-            return true;
+            *triggered = hit;
         }
-        else if (OffHasNotFlag(m_window->m_flagsWindow, OfficeWindow::NoMaximizeButton) &&
-            m_maximizeRectangle.contains(pos))
+
+        if (next != current)
         {
-            m_stateMaximize = ButtonHover;
-            return true;
+            m_buttonStates[i] = next;
+            dirty += m_layout->buttonRectangles[i];
         }
-        else if (OffHasNotFlag(m_window->m_flagsWindow, OfficeWindow::NoMinimizeButton) &&
-            m_minimizeRectangle.contains(pos))
+    }
+
+    return dirty;
+}
+
+bool priv::Titlebar::mouseMoveDrag(const QPoint& pos)
+{
+    if (m_window->m_stateWindow == OfficeWindow::StateDrag)
+    {
+        auto globalPos = m_window->mapToGlobal(pos);
+        if (m_window->isMaximized())
         {
-            m_stateMinimize = ButtonHover;
-            return true;
+            m_window->m_stateWindow = OfficeWindow::StateNone;
+
+            toggleMaximized();
+        }
+        else
+        {
+            m_window->move(globalPos - m_dragPosition);
+            m_window->updateGeometry();
         }
 
-        return state;
+        return true;
     }
 
     return false;
@@ -425,7 +573,7 @@ bool priv::Titlebar::mousePressDrag(const QPoint& pos)
 {
     // Activates dragging if the dragging rectangle is being pressed and
     // moved later on.
-    if (m_dragRectangle.contains(pos))
+    if (m_layout->dragRectangle.contains(pos))
     {
         m_dragPosition = pos;
         m_window->m_stateWindow = OfficeWindow::StateDrag;
@@ -436,100 +584,60 @@ bool priv::Titlebar::mousePressDrag(const QPoint& pos)
     return false;
 }
 
-bool priv::Titlebar::mousePressHitTest(const QPoint& pos)
+bool priv::Titlebar::mouseReleaseDrag(const QPoint&)
 {
-    bool state = m_stateClose    != ButtonPress &&
-                 m_stateMaximize != ButtonPress &&
-                 m_stateMinimize != ButtonPress;
+    if (m_window->m_stateWindow == OfficeWindow::StateDrag)
+    {
+        m_window->m_stateWindow = OfficeWindow::StateNone;
 
-    m_stateClose    = ButtonNone;
-    m_stateMaximize = ButtonNone;
-    m_stateMinimize = ButtonNone;
+        return true;
+    }
 
-    if (OffHasNotFlag(m_window->m_flagsWindow, OfficeWindow::NoCloseButton) &&
-        m_closeRectangle.contains(pos))
+    return false;
+}
+
+void priv::Titlebar::mouseReleaseAction(Button button)
+{
+    if (button == CloseButton)
     {
-        m_stateClose = ButtonPress;
-        return true;
+        m_window->close();
     }
-    else if (OffHasNotFlag(m_window->m_flagsWindow, OfficeWindow::NoMaximizeButton) &&
-        m_maximizeRectangle.contains(pos))
+    else if (button == MaximizeButton)
     {
-        m_stateMaximize = ButtonPress;
-        return true;
+        toggleMaximized();
     }
-    else if (OffHasNotFlag(m_window->m_flagsWindow, OfficeWindow::NoMinimizeButton) &&
-        m_minimizeRectangle.contains(pos))
+    else if (button == MinimizeButton)
     {
-        m_stateMinimize = ButtonPress;
-        return true;
+        m_window->showMinimized();
     }
-
-    return state;
 }
 
-bool priv::Titlebar::mouseReleaseDrag(const QPoint&)
+const QPixmap& priv::Titlebar::buttonImage(Button button) const
 {
-    if (m_window->m_stateWindow == OfficeWindow::StateDrag)
+    if (button == CloseButton)
     {
-        m_window->m_stateWindow = OfficeWindow::StateNone;
-
-        return true;
+        return m_imageClose;
+    }
+    else if (button == MinimizeButton)
+    {
+        return m_imageMinimize;
     }
 
-    return false;
+    return m_window->isMaximized() ? m_imageRestore : m_imageMaximize;
 }
 
-bool priv::Titlebar::mouseReleaseAction(const QPoint& pos)
+bool priv::Titlebar::LayerKey::operator ==(const LayerKey& other) const
 {
-    if (m_stateClose    == ButtonPress   ||
-        m_stateClose    == ButtonSpecial ||
-        m_stateMaximize == ButtonPress   ||
-        m_stateMaximize == ButtonSpecial ||
-        m_stateMinimize == ButtonPress   ||
-        m_stateMinimize == ButtonSpecial)
-    {
-        if (m_stateClose == ButtonPress && m_closeRectangle.contains(pos))
-        {
-            m_window->close();
-        }
-        else if (m_stateMaximize == ButtonPress && m_maximizeRectangle.contains(pos))
-        {
-            // The window is about to be maximized or restored. In order to
-            // avoid that all the titlebar's contents are invisible for a split
-            // second, we recalculate all the necessary things beforehand.
-            updateRectangles();
-            updateVisibleTitle();
-            m_window->updateResizeRectangles();
-
-            if (m_window->isMaximized())
-            {
-                m_window->showNormal();
-            }
-            else
-            {
-                m_window->showMaximized();
-            }
-
-            m_window->updateLayoutPadding();
-        }
-        else if (m_stateMinimize == ButtonPress && m_minimizeRectangle.contains(pos))
-        {
-            m_window->updateLayoutPadding();
-            m_window->showMinimized();
-        }
-
-        m_stateClose    = ButtonNone;
-        m_stateMaximize = ButtonNone;
-        m_stateMinimize = ButtonNone;
-
-        return true;
-    }
-
-    return false;
+    return accent    == other.accent    &&
+           flags     == other.flags     &&
+           active    == other.active    &&
+           maximized == other.maximized &&
+           ratio     == other.ratio     &&
+           size      == other.size      &&
+           title     == other.title;
 }
 
-QRect priv::Titlebar::centerRectangle(const QPixmap& pm, const QRect& rc)
+QRect priv::Titlebar::centerRectangle(const QPixmap& pm, const QRect& rc) const
 {
     int dx = (rc.width()  - pm.width())  / 2;
     int dy = (rc.height() - pm.height()) / 2;
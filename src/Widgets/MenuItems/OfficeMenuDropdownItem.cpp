@@ -0,0 +1,488 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// QOffice - The office framework for Qt
+// Copyright (C) 2016-2018 Nicolas Kogler
+//
+// This file is part of the Widget module.
+//
+// QOffice is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// QOffice is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with QOffice. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QOffice/Design/OfficePalette.hpp>
+#include <QOffice/Widgets/MenuItems/OfficeMenuDropdownItem.hpp>
+#include <QOffice/Widgets/OfficeMenuEventHandle.hpp>
+
+#include <QApplication>
+#include <QBoxLayout>
+#include <QKeyEvent>
+#include <QPainter>
+#include <QStringListModel>
+
+#include <algorithm>
+
+static QOFFICE_CONSTEXPR int c_defaultWidth = 120;
+static QOFFICE_CONSTEXPR int c_textPadding = 4;
+static QOFFICE_CONSTEXPR int c_arrowWidth = 14;
+static QOFFICE_CONSTEXPR int c_arrowSize = 3;
+
+priv::PrefixIndex::PrefixIndex()
+    : m_isValid(false)
+{
+}
+
+void priv::PrefixIndex::invalidate()
+{
+    m_isValid = false;
+    m_entries.clear();
+}
+
+int priv::PrefixIndex::find(const QAbstractItemModel* model, const QString& prefix)
+{
+    if (!m_isValid)
+    {
+        OffTraceScope("PrefixIndex::build");
+
+        const int rows = model->rowCount();
+        m_entries.clear();
+        m_entries.reserve(rows);
+
+        for (int row = 0; row < rows; row++)
+        {
+            const QString text = model->index(row, 0).data(Qt::DisplayRole).toString();
+            m_entries.append({ text.toCaseFolded(), row });
+        }
+
+        std::sort(m_entries.begin(), m_entries.end(), [](const Entry& a, const Entry& b)
+            {
+                return a.key != b.key ? a.key < b.key : a.row < b.row;
+            });
+
+        m_isValid = true;
+    }
+
+    // The first key that is not less than the prefix is the only candidate;
+    // every key that starts with the prefix sorts right behind it.
+    const QString key = prefix.toCaseFolded();
+    auto it = std::lower_bound(m_entries.cbegin(), m_entries.cend(), key,
+        [](const Entry& entry, const QString& value)
+            {
+                return entry.key < value;
+            });
+
+    if (it != m_entries.cend() && it->key.startsWith(key))
+    {
+        return it->row;
+    }
+
+    return -1;
+}
+
+priv::DropdownView::DropdownView(QWidget* parent, OfficeMenuDropdownItem* item)
+    : QListView(parent)
+    , m_item(item)
+{
+    // Uniform rows are measured once, no matter how many there are.
+    setUniformItemSizes(true);
+    setEditTriggers(QAbstractItemView::NoEditTriggers);
+    setSelectionMode(QAbstractItemView::SingleSelection);
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    setFrameShape(QFrame::NoFrame);
+    setMouseTracking(true);
+}
+
+void priv::DropdownView::keyboardSearch(const QString& search)
+{
+    m_item->typeAhead(search);
+}
+
+void priv::DropdownView::keyPressEvent(QKeyEvent* event)
+{
+    switch (event->key())
+    {
+    case Qt::Key_Return:
+    case Qt::Key_Enter:
+        m_item->choose(currentIndex().row());
+        break;
+
+    case Qt::Key_Escape:
+        m_item->hidePopup();
+        break;
+
+    default:
+        QListView::keyPressEvent(event);
+        break;
+    }
+}
+
+OfficeMenuDropdownItem::OfficeMenuDropdownItem(const QStringList& items)
+    : QWidget()
+    , m_items(new QStringListModel(items, this))
+    , m_model(nullptr)
+    , m_popup(nullptr)
+    , m_view(nullptr)
+    , m_maxVisibleItems(20)
+    , m_hasCurrent(false)
+{
+    init();
+    setModel(m_items);
+}
+
+OfficeMenuDropdownItem::OfficeMenuDropdownItem(QAbstractItemModel* model)
+    : QWidget()
+    , m_items(nullptr)
+    , m_model(nullptr)
+    , m_popup(nullptr)
+    , m_view(nullptr)
+    , m_maxVisibleItems(20)
+    , m_hasCurrent(false)
+{
+    init();
+    setModel(model);
+}
+
+QAbstractItemModel* OfficeMenuDropdownItem::model() const
+{
+    return m_model;
+}
+
+int OfficeMenuDropdownItem::currentIndex() const
+{
+    return m_current.isValid() ? m_current.row() : -1;
+}
+
+QString OfficeMenuDropdownItem::currentText() const
+{
+    return m_current.data(Qt::DisplayRole).toString();
+}
+
+int OfficeMenuDropdownItem::maxVisibleItems() const
+{
+    return m_maxVisibleItems;
+}
+
+void OfficeMenuDropdownItem::setItems(const QStringList& items)
+{
+    if (m_items == nullptr)
+    {
+        m_items = new QStringListModel(this);
+    }
+
+    m_items->setStringList(items);
+    setModel(m_items);
+}
+
+void OfficeMenuDropdownItem::setModel(QAbstractItemModel* model)
+{
+    if (m_model != nullptr)
+    {
+        QObject::disconnect(m_model, nullptr, this, nullptr);
+    }
+
+    m_model = model;
+    m_view->setModel(model);
+    m_current = QPersistentModelIndex();
+    m_hasCurrent = false;
+    onModelChanged();
+
+    if (model == nullptr)
+    {
+        return;
+    }
+
+    // Any change to the rows or their texts invalidates the prefix index.
+    QObject::connect(model, &QAbstractItemModel::modelReset, this, &OfficeMenuDropdownItem::onModelChanged);
+    QObject::connect(model, &QAbstractItemModel::layoutChanged, this, &OfficeMenuDropdownItem::onModelChanged);
+    QObject::connect(model, &QAbstractItemModel::rowsInserted, this, &OfficeMenuDropdownItem::onModelChanged);
+    QObject::connect(model, &QAbstractItemModel::rowsRemoved, this, &OfficeMenuDropdownItem::onModelChanged);
+    QObject::connect(model, &QAbstractItemModel::rowsMoved, this, &OfficeMenuDropdownItem::onModelChanged);
+    QObject::connect(model, &QAbstractItemModel::dataChanged, this, &OfficeMenuDropdownItem::onModelChanged);
+}
+
+void OfficeMenuDropdownItem::setCurrentIndex(int row)
+{
+    const int rows = m_model != nullptr ? m_model->rowCount() : 0;
+    m_current = row >= 0 && row < rows ? m_model->index(row, 0) : QModelIndex();
+    m_hasCurrent = m_current.isValid();
+
+    update();
+}
+
+void OfficeMenuDropdownItem::setMaxVisibleItems(int count)
+{
+    m_maxVisibleItems = qMax(1, count);
+}
+
+void OfficeMenuDropdownItem::showPopup()
+{
+    OffTraceScope("OfficeMenuDropdownItem::showPopup");
+
+    if (m_model == nullptr || m_model->rowCount() == 0)
+    {
+        return;
+    }
+
+    // The height of the first row stands for all rows; nothing else is
+    // measured, regardless of the amount of rows.
+    const int rows = qMin(m_model->rowCount(), m_maxVisibleItems);
+    const int rowHeight = m_view->sizeHintForRow(0);
+    const QMargins margins = m_popup->layout()->contentsMargins();
+
+    m_popup->resize(
+        width(),
+        rows * rowHeight + margins.top() + margins.bottom()
+        );
+
+    const QModelIndex current = m_current.isValid() ? QModelIndex(m_current) : m_model->index(0, 0);
+    m_view->setCurrentIndex(current);
+    m_view->scrollTo(current, QAbstractItemView::PositionAtCenter);
+
+    m_popup->move(mapToGlobal(rect().bottomLeft()));
+    m_popup->show();
+    m_view->setFocus();
+}
+
+void OfficeMenuDropdownItem::hidePopup()
+{
+    m_popup->hide();
+    m_typeAhead.clear();
+}
+
+QSize OfficeMenuDropdownItem::sizeHint() const
+{
+    return QSize(c_defaultWidth, fontMetrics().height() + c_textPadding * 2);
+}
+
+QWidget* OfficeMenuDropdownItem::widget()
+{
+    return this;
+}
+
+QListView* OfficeMenuDropdownItem::popupView() const
+{
+    return m_view;
+}
+
+void OfficeMenuDropdownItem::paintEvent(QPaintEvent*)
+{
+    OffTraceScope("OfficeMenuDropdownItem::paint");
+
+    QPainter painter(this);
+
+    const QRect box = rect().adjusted(0,0,-1,-1);
+    const QRect textRect = rect().adjusted(c_textPadding, 0, -c_arrowWidth, 0);
+    const QPoint arrow(width() - c_arrowWidth / 2, height() / 2);
+    const QColor& colorForeground = OfficePalette::color(OfficePalette::Foreground);
+
+    if (m_popup->isVisible() || hasFocus())
+    {
+        painter.fillRect(rect(), OfficePalette::color(OfficePalette::MenuItemFocus));
+    }
+    else if (underMouse())
+    {
+        painter.fillRect(rect(), OfficePalette::color(OfficePalette::MenuItemHover));
+    }
+
+    // Border
+    painter.setPen(OfficePalette::color(OfficePalette::MenuSeparator));
+    painter.drawRect(box);
+
+    // Text
+    painter.setPen(colorForeground);
+    painter.drawText(
+        textRect,
+        Qt::AlignLeft | Qt::AlignVCenter,
+        fontMetrics().elidedText(currentText(), Qt::ElideRight, textRect.width())
+        );
+
+    // Drop-down arrow
+    const QPoint points[] =
+    {
+        arrow + QPoint(-c_arrowSize, -c_arrowSize / 2),
+        arrow + QPoint(c_arrowSize, -c_arrowSize / 2),
+        arrow + QPoint(0, c_arrowSize)
+    };
+
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setBrush(colorForeground);
+    painter.setPen(Qt::NoPen);
+    painter.drawPolygon(points, 3);
+}
+
+void OfficeMenuDropdownItem::keyPressEvent(QKeyEvent* event)
+{
+    const int rows = m_model != nullptr ? m_model->rowCount() : 0;
+
+    switch (event->key())
+    {
+    case Qt::Key_F4:
+    case Qt::Key_Space:
+        showPopup();
+        break;
+
+    case Qt::Key_Up:
+        if (event->modifiers() & Qt::AltModifier)
+            showPopup();
+        else if (currentIndex() > 0)
+            choose(currentIndex() - 1);
+        break;
+
+    case Qt::Key_Down:
+        if (event->modifiers() & Qt::AltModifier)
+            showPopup();
+        else if (currentIndex() < rows - 1)
+            choose(currentIndex() + 1);
+        break;
+
+    default:
+        if (!event->text().isEmpty() && event->text().at(0).isPrint())
+            typeAhead(event->text());
+        else
+            QWidget::keyPressEvent(event);
+        break;
+    }
+}
+
+void OfficeMenuDropdownItem::mousePressEvent(QMouseEvent* event)
+{
+    if (event->button() == Qt::LeftButton)
+    {
+        setFocus(Qt::MouseFocusReason);
+        showPopup();
+    }
+
+    QWidget::mousePressEvent(event);
+}
+
+void OfficeMenuDropdownItem::wheelEvent(QWheelEvent* event)
+{
+    const int rows = m_model != nullptr ? m_model->rowCount() : 0;
+    const int step = event->angleDelta().y() > 0 ? -1 : 1;
+    const int row = currentIndex() + step;
+
+    if (hasFocus() && row >= 0 && row < rows)
+    {
+        choose(row);
+    }
+
+    event->accept();
+}
+
+void OfficeMenuDropdownItem::onClicked(const QModelIndex& index)
+{
+    choose(index.row());
+}
+
+void OfficeMenuDropdownItem::onModelChanged()
+{
+    m_index.invalidate();
+    update();
+
+    // The persistent index follows the chosen entry through insertions, moves
+    // and removals of other rows. Only if the entry itself is gone, the
+    // choice changes and is reported.
+    if (m_hasCurrent && !m_current.isValid())
+    {
+        m_hasCurrent = false;
+
+        emitItemEvent(OfficeMenuEventHandle::create<OfficeMenuItemChangedEvent>(
+            id(), -1, QString(), QVariant()
+            ));
+    }
+}
+
+void OfficeMenuDropdownItem::typeAhead(const QString& text)
+{
+    if (m_model == nullptr)
+    {
+        return;
+    }
+
+    // Keystrokes in quick succession extend the typed prefix.
+    if (!m_typeAheadTimer.isValid() ||
+        m_typeAheadTimer.elapsed() > QApplication::keyboardInputInterval())
+    {
+        m_typeAhead.clear();
+    }
+
+    m_typeAhead += text;
+    m_typeAheadTimer.restart();
+
+    const int row = m_index.find(m_model, m_typeAhead);
+    if (row == -1)
+    {
+        return;
+    }
+
+    if (m_popup->isVisible())
+    {
+        // Only moves the cursor; the return key chooses the entry.
+        const QModelIndex index = m_model->index(row, 0);
+        m_view->setCurrentIndex(index);
+        m_view->scrollTo(index, QAbstractItemView::PositionAtCenter);
+    }
+    else if (row != currentIndex())
+    {
+        choose(row);
+    }
+}
+
+void OfficeMenuDropdownItem::choose(int row)
+{
+    hidePopup();
+
+    if (m_model == nullptr || row < 0 || row >= m_model->rowCount())
+    {
+        return;
+    }
+
+    const QModelIndex index = m_model->index(row, 0);
+    m_current = index;
+    m_hasCurrent = true;
+    update();
+
+    const QString text = index.data(Qt::DisplayRole).toString();
+    QVariant value = index.data(ValueRole);
+    if (!value.isValid())
+    {
+        value = text;
+    }
+
+    emitItemEvent(OfficeMenuEventHandle::create<OfficeMenuItemChangedEvent>(
+        id(), row, text, value
+        ));
+}
+
+void OfficeMenuDropdownItem::init()
+{
+    m_popup = new QWidget(this, Qt::Popup);
+    m_view = new priv::DropdownView(m_popup, this);
+
+    QVBoxLayout* layout = new QVBoxLayout(m_popup);
+    layout->setContentsMargins(1,1,1,1);
+    layout->addWidget(m_view);
+
+    m_view->setModel(m_model);
+
+    setFocusPolicy(Qt::ClickFocus);
+    setAttribute(Qt::WA_Hover);
+    setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Fixed);
+
+    QObject::connect(
+        m_view,
+        &QListView::clicked,
+        this,
+        &OfficeMenuDropdownItem::onClicked
+        );
+}
@@ -0,0 +1,250 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// QOffice - The office framework for Qt
+// Copyright (C) 2016-2018 Nicolas Kogler
+//
+// This file is part of the Widget module.
+//
+// QOffice is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// QOffice is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with QOffice. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QOffice/Design/OfficeFont.hpp>
+#include <QOffice/Design/OfficePalette.hpp>
+#include <QOffice/Widgets/MenuItems/OfficeMenuFontPickerItem.hpp>
+#include <QOffice/Widgets/MenuItems/OfficeMenuThumbnailCache.hpp>
+
+#include <QFontDatabase>
+#include <QPainter>
+#include <QStyledItemDelegate>
+
+static QOFFICE_CONSTEXPR int c_padding = 3;
+static QOFFICE_CONSTEXPR int c_previewWidth = 180;
+static QOFFICE_CONSTEXPR int c_previewHeight = 22;
+static QOFFICE_CONSTEXPR int c_defaultCapacity = 512;
+
+static QStringList installedFamilies()
+{
+    OffTraceScope("OfficeMenuFontPickerItem::installedFamilies");
+
+    return QFontDatabase().families();
+}
+
+static QImage renderPreview(const QString& family, const QSize& size, const QColor& color)
+{
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+
+    // Resolving the face of the family is the expensive part, which is why
+    // this runs on a worker thread.
+    QFont font(family);
+    font.setPointSizeF(OfficeFont::Large);
+
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::TextAntialiasing);
+    painter.setFont(font);
+    painter.setPen(color);
+    painter.drawText(
+        image.rect(),
+        Qt::AlignLeft | Qt::AlignVCenter,
+        painter.fontMetrics().elidedText(family, Qt::ElideRight, size.width())
+        );
+
+    return image;
+}
+
+namespace priv
+{
+// Paints the families of a font picker. Previews that are not cached yet are
+// requested from the cache and replaced by the plain family name meanwhile.
+class FontPreviewDelegate : public QStyledItemDelegate
+{
+public:
+
+    FontPreviewDelegate(QObject* parent, ThumbnailCache* cache)
+        : QStyledItemDelegate(parent)
+        , m_cache(cache)
+    {
+    }
+
+    QSize sizeHint(const QStyleOptionViewItem&, const QModelIndex&) const override
+    {
+        const QSize& preview = m_cache->size();
+
+        return QSize(preview.width() + c_padding * 2, preview.height() + c_padding * 2);
+    }
+
+    void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override
+    {
+        OffTraceScope("FontPreviewDelegate::paint");
+
+        const QString family = index.data(Qt::DisplayRole).toString();
+        const QRect row = option.rect;
+        const QRect preview(
+            row.x() + c_padding,
+            row.y() + c_padding,
+            row.width() - c_padding * 2,
+            m_cache->size().height()
+            );
+
+        painter->save();
+
+        if (option.state & QStyle::State_Selected)
+        {
+            painter->fillRect(row, OfficePalette::color(OfficePalette::MenuItemPress));
+        }
+        else if (option.state & QStyle::State_MouseOver)
+        {
+            painter->fillRect(row, OfficePalette::color(OfficePalette::MenuItemHover));
+        }
+
+        const QPixmap* pixmap = m_cache->find(family);
+        if (pixmap != nullptr && !pixmap->isNull())
+        {
+            painter->drawPixmap(preview.topLeft(), *pixmap);
+        }
+        else
+        {
+            if (pixmap == nullptr)
+            {
+                m_cache->request(family);
+            }
+
+            const QFont& font = OfficeFont::font(OfficeFont::Regular, OfficeFont::Medium);
+            painter->setFont(font);
+            painter->setPen(OfficePalette::color(OfficePalette::Foreground));
+            painter->drawText(
+                preview,
+                Qt::AlignLeft | Qt::AlignVCenter,
+                QFontMetrics(font).elidedText(family, Qt::ElideRight, preview.width())
+                );
+        }
+
+        painter->restore();
+    }
+
+private:
+
+    ThumbnailCache* m_cache;
+};
+}
+
+OfficeMenuFontPickerItem::OfficeMenuFontPickerItem()
+    : OfficeMenuDropdownItem(installedFamilies())
+    , m_previews(nullptr)
+    , m_delegate(nullptr)
+{
+    init();
+}
+
+OfficeMenuFontPickerItem::OfficeMenuFontPickerItem(const QStringList& families)
+    : OfficeMenuDropdownItem(families)
+    , m_previews(nullptr)
+    , m_delegate(nullptr)
+{
+    init();
+}
+
+QFont OfficeMenuFontPickerItem::currentFont() const
+{
+    QFont font;
+    if (currentIndex() != -1)
+    {
+        font.setFamily(currentText());
+    }
+
+    return font;
+}
+
+bool OfficeMenuFontPickerItem::setCurrentFont(const QFont& font)
+{
+    const QAbstractItemModel* items = model();
+    if (items == nullptr || items->rowCount() == 0)
+    {
+        return false;
+    }
+
+    const QModelIndexList matches = items->match(
+        items->index(0, 0),
+        Qt::DisplayRole,
+        font.family(),
+        1,
+        Qt::MatchFixedString
+        );
+
+    if (matches.isEmpty())
+    {
+        return false;
+    }
+
+    setCurrentIndex(matches.first().row());
+    return true;
+}
+
+int OfficeMenuFontPickerItem::previewCapacity() const
+{
+    return m_previews->capacity();
+}
+
+void OfficeMenuFontPickerItem::setPreviewCapacity(int capacity)
+{
+    m_previews->setCapacity(capacity);
+}
+
+QSize OfficeMenuFontPickerItem::sizeHint() const
+{
+    const QSize hint = OfficeMenuDropdownItem::sizeHint();
+
+    return QSize(qMax(hint.width(), c_previewWidth + c_padding * 2), hint.height());
+}
+
+void OfficeMenuFontPickerItem::onPreviewReady()
+{
+    // Only the visible rows are repainted.
+    if (popupView()->isVisible())
+    {
+        popupView()->viewport()->update();
+    }
+}
+
+void OfficeMenuFontPickerItem::init()
+{
+    // Without threaded font rendering, the cache has no loader and every row
+    // keeps showing its family name in the UI font.
+    priv::ThumbnailCache::Loader loader;
+    if (QFontDatabase::supportsThreadedFontRendering())
+    {
+        const QColor color = OfficePalette::color(OfficePalette::Foreground);
+        loader = [color](const QString& family, const QSize& size)
+            {
+                return renderPreview(family, size, color);
+            };
+    }
+
+    // The cache belongs to the item rather than the popup, hence previews
+    // survive closing and reopening the popup.
+    m_previews = new priv::ThumbnailCache(this, loader);
+    m_previews->setSize(QSize(c_previewWidth, c_previewHeight));
+    m_previews->setCapacity(c_defaultCapacity);
+
+    m_delegate = new priv::FontPreviewDelegate(this, m_previews);
+    popupView()->setItemDelegate(m_delegate);
+
+    QObject::connect(
+        m_previews,
+        &priv::ThumbnailCache::thumbnailReady,
+        this,
+        &OfficeMenuFontPickerItem::onPreviewReady
+        );
+}
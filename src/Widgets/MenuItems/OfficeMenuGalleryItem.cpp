@@ -0,0 +1,423 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// QOffice - The office framework for Qt
+// Copyright (C) 2016-2018 Nicolas Kogler
+//
+// This file is part of the Widget module.
+//
+// QOffice is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// QOffice is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with QOffice. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QOffice/Design/OfficePalette.hpp>
+#include <QOffice/Widgets/MenuItems/OfficeMenuGalleryItem.hpp>
+#include <QOffice/Widgets/OfficeMenuEventHandle.hpp>
+
+#include <QAbstractItemModel>
+#include <QBoxLayout>
+#include <QListView>
+#include <QPainter>
+#include <QScrollBar>
+#include <QStyledItemDelegate>
+#include <QToolButton>
+
+static QOFFICE_CONSTEXPR int c_padding = 3;
+static QOFFICE_CONSTEXPR int c_inlineColumns = 6;
+static QOFFICE_CONSTEXPR int c_popupRows = 6;
+
+static QImage loadImage(const QString& path, const QSize& size)
+{
+    QImage image(path);
+    if (image.isNull())
+    {
+        return image;
+    }
+
+    return image.scaled(size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+}
+
+namespace priv
+{
+// Paints the cells of a gallery. Thumbnails that are not cached yet are
+// requested from the cache and replaced by a placeholder in the meantime.
+class GalleryDelegate : public QStyledItemDelegate
+{
+public:
+
+    GalleryDelegate(QObject* parent, ThumbnailCache* cache)
+        : QStyledItemDelegate(parent)
+        , m_cache(cache)
+    {
+    }
+
+    QSize sizeHint(const QStyleOptionViewItem& option, const QModelIndex&) const override
+    {
+        const QSize& thumbnail = m_cache->size();
+
+        return QSize(
+            thumbnail.width() + c_padding * 2,
+            thumbnail.height() + c_padding * 3 + option.fontMetrics.height()
+            );
+    }
+
+    void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override
+    {
+        OffTraceScope("GalleryDelegate::paint");
+
+        const QSize& size = m_cache->size();
+        const QRect cell = option.rect;
+        const QRect thumbnail(
+            cell.x() + (cell.width() - size.width()) / 2,
+            cell.y() + c_padding,
+            size.width(),
+            size.height()
+            );
+
+        const QRect text(
+            cell.x() + c_padding,
+            thumbnail.bottom() + c_padding,
+            cell.width() - c_padding * 2,
+            option.fontMetrics.height()
+            );
+
+        painter->save();
+
+        if (option.state & QStyle::State_Selected)
+        {
+            painter->fillRect(cell, OfficePalette::color(OfficePalette::MenuItemPress));
+        }
+        else if (option.state & QStyle::State_MouseOver)
+        {
+            painter->fillRect(cell, OfficePalette::color(OfficePalette::MenuItemHover));
+        }
+
+        const QVariant decoration = index.data(Qt::DecorationRole);
+        if (decoration.canConvert<QIcon>() && !decoration.value<QIcon>().isNull())
+        {
+            decoration.value<QIcon>().paint(painter, thumbnail);
+        }
+        else
+        {
+            const QString key = index.data(OfficeMenuGalleryItem::ThumbnailRole).toString();
+            const QPixmap* pixmap = key.isEmpty() ? nullptr : m_cache->find(key);
+
+            if (pixmap != nullptr && !pixmap->isNull())
+            {
+                const QRect target(QPoint(), pixmap->size());
+                painter->drawPixmap(target.translated(thumbnail.center() - target.center()), *pixmap);
+            }
+            else
+            {
+                if (pixmap == nullptr && !key.isEmpty())
+                {
+                    m_cache->request(key);
+                }
+
+                painter->fillRect(thumbnail, OfficePalette::color(OfficePalette::MenuSeparator));
+            }
+        }
+
+        const QString label = option.fontMetrics.elidedText(
+            index.data(Qt::DisplayRole).toString(),
+            Qt::ElideRight,
+            text.width()
+            );
+
+        painter->setPen(OfficePalette::color(OfficePalette::Foreground));
+        painter->drawText(text, Qt::AlignCenter, label);
+        painter->restore();
+    }
+
+private:
+
+    ThumbnailCache* m_cache;
+};
+}
+
+static void setupView(QListView* view, priv::GalleryDelegate* delegate)
+{
+    // A static, wrapping list of uniform cells is laid out arithmetically
+    // and only paints the cells that intersect the viewport.
+    view->setViewMode(QListView::ListMode);
+    view->setFlow(QListView::LeftToRight);
+    view->setWrapping(true);
+    view->setMovement(QListView::Static);
+    view->setResizeMode(QListView::Adjust);
+    view->setUniformItemSizes(true);
+    view->setLayoutMode(QListView::Batched);
+    view->setVerticalScrollMode(QAbstractItemView::ScrollPerItem);
+    view->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    view->setSelectionMode(QAbstractItemView::SingleSelection);
+    view->setFrameShape(QFrame::NoFrame);
+    view->setMouseTracking(true);
+    view->setItemDelegate(delegate);
+}
+
+static void collectVisibleKeys(QListView* view, QSet<QString>& keys)
+{
+    const QAbstractItemModel* model = view->model();
+    const QRect area = view->viewport()->rect();
+    const QModelIndex first = view->indexAt(area.topLeft());
+
+    if (model == nullptr || !first.isValid())
+    {
+        return;
+    }
+
+    // The cells flow left to right, hence the visible ones are consecutive.
+    for (int row = first.row(); row < model->rowCount(); row++)
+    {
+        const QModelIndex index = model->index(row, view->modelColumn());
+        const QRect cell = view->visualRect(index);
+
+        if (cell.top() > area.bottom())
+        {
+            break;
+        }
+
+        const QString key = index.data(OfficeMenuGalleryItem::ThumbnailRole).toString();
+        if (!key.isEmpty() && cell.intersects(area))
+        {
+            keys.insert(key);
+        }
+    }
+}
+
+OfficeMenuGalleryItem::OfficeMenuGalleryItem(QAbstractItemModel* model)
+    : QWidget()
+    , m_cache(new priv::ThumbnailCache(this, &loadImage))
+    , m_delegate(new priv::GalleryDelegate(this, m_cache))
+    , m_view(new QListView(this))
+    , m_popupView(nullptr)
+    , m_popup(new QWidget(this, Qt::Popup))
+    , m_popupButton(new QToolButton(this))
+    , m_isSelecting(false)
+{
+    QHBoxLayout* layout = new QHBoxLayout(this);
+    layout->setContentsMargins(0,0,0,0);
+    layout->setSpacing(0);
+    layout->addWidget(m_view);
+    layout->addWidget(m_popupButton, 0, Qt::AlignBottom);
+
+    QVBoxLayout* popupLayout = new QVBoxLayout(m_popup);
+    popupLayout->setContentsMargins(1,1,1,1);
+    m_popupView = new QListView(m_popup);
+    popupLayout->addWidget(m_popupView);
+
+    setupView(m_view, m_delegate);
+    setupView(m_popupView, m_delegate);
+    m_view->viewport()->installEventFilter(this);
+    m_popupView->viewport()->installEventFilter(this);
+    m_view->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    m_popupView->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOn);
+
+    m_popupButton->setArrowType(Qt::DownArrow);
+    m_popupButton->setAutoRaise(true);
+    m_popupButton->setFocusPolicy(Qt::NoFocus);
+
+    setFocusPolicy(Qt::ClickFocus);
+    setFocusProxy(m_view);
+    setModel(model);
+    updateCellSize();
+
+    QObject::connect(
+        m_cache,
+        &priv::ThumbnailCache::thumbnailReady,
+        this,
+        &OfficeMenuGalleryItem::onThumbnailReady
+        );
+
+    QObject::connect(
+        m_popupButton,
+        &QToolButton::clicked,
+        this,
+        &OfficeMenuGalleryItem::showPopup
+        );
+
+    // Keyboard navigation within the popup selects cells, but only a click
+    // or the return key closes it.
+    QObject::connect(
+        m_popupView,
+        &QListView::clicked,
+        m_popup,
+        &QWidget::hide
+        );
+
+    QObject::connect(
+        m_popupView,
+        &QListView::activated,
+        m_popup,
+        &QWidget::hide
+        );
+}
+
+QAbstractItemModel* OfficeMenuGalleryItem::model() const
+{
+    return m_view->model();
+}
+
+QSize OfficeMenuGalleryItem::thumbnailSize() const
+{
+    return m_cache->size();
+}
+
+int OfficeMenuGalleryItem::cacheCapacity() const
+{
+    return m_cache->capacity();
+}
+
+int OfficeMenuGalleryItem::currentRow() const
+{
+    const QModelIndex index = m_view->currentIndex();
+    return index.isValid() ? index.row() : -1;
+}
+
+void OfficeMenuGalleryItem::setModel(QAbstractItemModel* model)
+{
+    // Both views share one selection model. The ones created by setModel are
+    // not deleted by the views themselves.
+    QItemSelectionModel* previous = m_view->selectionModel();
+    m_view->setModel(model);
+    m_popupView->setModel(model);
+
+    QItemSelectionModel* created = m_popupView->selectionModel();
+    m_popupView->setSelectionModel(m_view->selectionModel());
+
+    delete created;
+    delete previous;
+
+    QObject::connect(
+        m_view->selectionModel(),
+        &QItemSelectionModel::currentChanged,
+        this,
+        &OfficeMenuGalleryItem::onCurrentChanged
+        );
+}
+
+void OfficeMenuGalleryItem::setThumbnailSize(const QSize& size)
+{
+    m_cache->setSize(size);
+    updateCellSize();
+}
+
+void OfficeMenuGalleryItem::setCacheCapacity(int capacity)
+{
+    m_cache->setCapacity(capacity);
+}
+
+void OfficeMenuGalleryItem::setThumbnailLoader(ThumbnailLoader loader)
+{
+    m_cache->setLoader(std::move(loader));
+    onThumbnailReady();
+}
+
+void OfficeMenuGalleryItem::setCurrentRow(int row)
+{
+    QAbstractItemModel* model = m_view->model();
+
+    m_isSelecting = true;
+    m_view->setCurrentIndex(model != nullptr ? model->index(row, 0) : QModelIndex());
+    m_isSelecting = false;
+}
+
+void OfficeMenuGalleryItem::showPopup()
+{
+    const QSize cell = m_view->gridSize();
+    const int scrollBar = m_popupView->verticalScrollBar()->sizeHint().width();
+
+    m_popupView->setFixedSize(
+        qMax(width(), cell.width() * c_inlineColumns) + scrollBar,
+        cell.height() * c_popupRows
+        );
+
+    m_popup->adjustSize();
+    m_popup->move(mapToGlobal(QPoint(0, 0)));
+    m_popup->show();
+    m_popupView->scrollTo(m_view->currentIndex());
+    m_popupView->setFocus();
+}
+
+QWidget* OfficeMenuGalleryItem::widget()
+{
+    return this;
+}
+
+bool OfficeMenuGalleryItem::eventFilter(QObject* watched, QEvent* event)
+{
+    // Scrolling paints the cells that became visible, which is the moment the
+    // loads of the cells that were scrolled away become obsolete.
+    if (event->type() == QEvent::Paint && m_cache->hasPending())
+    {
+        retainVisibleThumbnails();
+    }
+
+    return QWidget::eventFilter(watched, event);
+}
+
+void OfficeMenuGalleryItem::onCurrentChanged(const QModelIndex& current, const QModelIndex&)
+{
+    if (m_isSelecting || !current.isValid())
+    {
+        return;
+    }
+
+    m_view->scrollTo(current);
+
+    const QString text = current.data(Qt::DisplayRole).toString();
+    QVariant value = current.data(ValueRole);
+    if (!value.isValid())
+    {
+        value = text;
+    }
+
+    emitItemEvent(OfficeMenuEventHandle::create<OfficeMenuItemChangedEvent>(
+        id(), current.row(), text, value
+        ));
+}
+
+void OfficeMenuGalleryItem::onThumbnailReady()
+{
+    // Only the visible cells are repainted.
+    m_view->viewport()->update();
+
+    if (m_popup->isVisible())
+    {
+        m_popupView->viewport()->update();
+    }
+}
+
+void OfficeMenuGalleryItem::updateCellSize()
+{
+    QStyleOptionViewItem option;
+    option.initFrom(m_view);
+
+    const QSize cell = m_delegate->sizeHint(option, QModelIndex());
+
+    m_view->setGridSize(cell);
+    m_popupView->setGridSize(cell);
+    m_view->setFixedSize(cell.width() * c_inlineColumns, cell.height());
+}
+
+void OfficeMenuGalleryItem::retainVisibleThumbnails()
+{
+    QSet<QString> keys;
+    collectVisibleKeys(m_view, keys);
+
+    if (m_popup->isVisible())
+    {
+        collectVisibleKeys(m_popupView, keys);
+    }
+
+    m_cache->retain(keys);
+}
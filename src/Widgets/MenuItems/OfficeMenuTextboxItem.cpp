@@ -21,6 +21,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <QOffice/Widgets/MenuItems/OfficeMenuTextboxItem.hpp>
+#include <QOffice/Widgets/OfficeMenuEventHandle.hpp>
 
 OfficeMenuTextboxItem::OfficeMenuTextboxItem(const QString& initialText)
     : OfficeLineEdit()
@@ -35,6 +36,13 @@ OfficeMenuTextboxItem::OfficeMenuTextboxItem(const QString& initialText)
         this,
         &OfficeMenuTextboxItem::onTextChanged
         );
+
+    QObject::connect(
+        this,
+        &OfficeLineEdit::contentEdited,
+        this,
+        &OfficeMenuTextboxItem::onTextEdited
+        );
 }
 
 QWidget* OfficeMenuTextboxItem::widget()
@@ -44,7 +52,14 @@ QWidget* OfficeMenuTextboxItem::widget()
 
 void OfficeMenuTextboxItem::onTextChanged(QString previous, QString current)
 {
-    OfficeMenuTextChangedEvent event(id(), previous, current);
+    emitItemEvent(OfficeMenuEventHandle::create<OfficeMenuTextChangedEvent>(
+        id(), previous, current
+        ));
+}
 
-    emitItemEvent(&event);
+void OfficeMenuTextboxItem::onTextEdited(int position, int removed, const QString& inserted)
+{
+    emitItemEvent(OfficeMenuEventHandle::create<OfficeMenuTextEditedEvent>(
+        id(), position, removed, inserted
+        ));
 }
@@ -0,0 +1,214 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// QOffice - The office framework for Qt
+// Copyright (C) 2016-2018 Nicolas Kogler
+//
+// This file is part of the Widget module.
+//
+// QOffice is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// QOffice is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with QOffice. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QOffice/Widgets/MenuItems/OfficeMenuThumbnailCache.hpp>
+
+#include <QRunnable>
+
+static QOFFICE_CONSTEXPR int c_defaultCapacity = 256;
+static QOFFICE_CONSTEXPR int c_workerCount = 2;
+static QOFFICE_CONSTEXPR int c_defaultPendingLimit = 64;
+
+namespace
+{
+class LoadRunnable : public QRunnable
+{
+public:
+
+    LoadRunnable(std::function<void()> function)
+        : m_function(std::move(function))
+    {
+    }
+
+    void run() override
+    {
+        m_function();
+    }
+
+private:
+
+    std::function<void()> m_function;
+};
+}
+
+priv::ThumbnailCache::ThumbnailCache(QObject* parent, Loader loader)
+    : QObject(parent)
+    , m_cache(c_defaultCapacity)
+    , m_loader(std::move(loader))
+    , m_size(64, 64)
+    , m_pendingLimit(c_defaultPendingLimit)
+    , m_nextPriority(0)
+{
+    m_pool.setMaxThreadCount(c_workerCount);
+}
+
+priv::ThumbnailCache::~ThumbnailCache()
+{
+    // Drops the loads that did not start yet; the running ones post to this
+    // object, hence they need to finish before it is gone.
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+int priv::ThumbnailCache::capacity() const
+{
+    return m_cache.maxCost();
+}
+
+const QSize& priv::ThumbnailCache::size() const
+{
+    return m_size;
+}
+
+void priv::ThumbnailCache::setCapacity(int capacity)
+{
+    m_cache.setMaxCost(capacity);
+}
+
+void priv::ThumbnailCache::setSize(const QSize& size)
+{
+    if (size != m_size)
+    {
+        m_size = size;
+        clear();
+    }
+}
+
+void priv::ThumbnailCache::setLoader(Loader loader)
+{
+    m_loader = std::move(loader);
+    clear();
+}
+
+bool priv::ThumbnailCache::hasPending() const
+{
+    return !m_pending.isEmpty();
+}
+
+const QPixmap* priv::ThumbnailCache::find(const QString& key)
+{
+    // Also marks the thumbnail as most recently used.
+    return m_cache.object(key);
+}
+
+void priv::ThumbnailCache::request(const QString& key)
+{
+    if (m_loader == nullptr || m_cache.contains(key) || m_pending.contains(key))
+    {
+        return;
+    }
+
+    // Never queues more loads than there are visible cells; the oldest request
+    // is the one most likely scrolled away already.
+    if (m_pending.size() >= m_pendingLimit)
+    {
+        auto oldest = m_pending.begin();
+        for (auto it = m_pending.begin(); it != m_pending.end(); ++it)
+        {
+            if (it->priority < oldest->priority)
+                oldest = it;
+        }
+
+        cancel(oldest);
+    }
+
+    const Loader loader = m_loader;
+    const QSize size = m_size;
+    const Ticket ticket(new QAtomicInt(0));
+    const int priority = m_nextPriority++;
+
+    m_pending.insert(key, Pending { ticket, priority });
+
+    // The most recent request belongs to a cell that is visible right now,
+    // while older ones may have been scrolled away already. Cancelled loads
+    // stay queued, but return right away once they are picked up.
+    m_pool.start(new LoadRunnable([this, loader, key, size, ticket]()
+        {
+            if (ticket->loadAcquire() != 0)
+            {
+                return;
+            }
+
+            const QImage image = loader(key, size);
+
+            QMetaObject::invokeMethod(this, [this, ticket, key, image]()
+                {
+                    insert(ticket, key, image);
+                },
+                Qt::QueuedConnection
+                );
+        }),
+        priority
+        );
+}
+
+void priv::ThumbnailCache::retain(const QSet<QString>& keys)
+{
+    for (auto it = m_pending.begin(); it != m_pending.end();)
+    {
+        if (keys.contains(it.key()))
+        {
+            ++it;
+        }
+        else
+        {
+            it = cancel(it);
+        }
+    }
+
+    m_pendingLimit = qMax(keys.size(), 1);
+}
+
+void priv::ThumbnailCache::clear()
+{
+    for (auto it = m_pending.begin(); it != m_pending.end(); ++it)
+    {
+        it->ticket->storeRelease(1);
+    }
+
+    m_pool.clear();
+    m_cache.clear();
+    m_pending.clear();
+}
+
+QHash<QString, priv::ThumbnailCache::Pending>::iterator
+priv::ThumbnailCache::cancel(QHash<QString, Pending>::iterator it)
+{
+    it->ticket->storeRelease(1);
+    return m_pending.erase(it);
+}
+
+void priv::ThumbnailCache::insert(const Ticket& ticket, const QString& key, const QImage& image)
+{
+    // Thumbnails of cancelled loads, or of another size or loader, are
+    // discarded; they would only push visible thumbnails out of the cache.
+    auto it = m_pending.find(key);
+    if (it == m_pending.end() || it->ticket != ticket)
+    {
+        return;
+    }
+
+    m_pending.erase(it);
+    m_cache.insert(key, new QPixmap(QPixmap::fromImage(image)), 1);
+
+    emit thumbnailReady(key);
+}
@@ -25,12 +25,17 @@
 #include <QOffice/Widgets/OfficeLineEdit.hpp>
 
 #include <QKeyEvent>
+#include <QTimer>
 
 OfficeLineEdit::OfficeLineEdit(QWidget* parent)
     : QLineEdit(parent)
     , m_format(Default)
+    , m_timer(new QTimer(this))
     , m_hasTyped(false)
 {
+    m_timer->setSingleShot(true);
+    m_timer->setInterval(0);
+
     QString css = Office::loadStyleSheet("OfficeLineEdit");
     QString co0 = Office::colorToHex(QColor(Qt::white));
     QString co1 = Office::colorToHex(OfficePalette::color(OfficePalette::MenuItemHover));
@@ -44,6 +49,21 @@ OfficeLineEdit::OfficeLineEdit(QWidget* parent)
         this,
         &OfficeLineEdit::generateEvent
         );
+
+    QObject::connect(
+        m_timer,
+        &QTimer::timeout,
+        this,
+        &OfficeLineEdit::flushEvent
+        );
+
+    // Does not keep the owner waiting for the rest of the quiet period.
+    QObject::connect(
+        this,
+        &QLineEdit::editingFinished,
+        this,
+        &OfficeLineEdit::flushEvent
+        );
 }
 
 OfficeLineEdit::Format OfficeLineEdit::format() const
@@ -58,6 +78,16 @@ void OfficeLineEdit::setFormat(OfficeLineEdit::Format format)
     clear();
 }
 
+int OfficeLineEdit::coalescePeriod() const
+{
+    return m_timer->interval();
+}
+
+void OfficeLineEdit::setCoalescePeriod(int milliseconds)
+{
+    m_timer->setInterval(qMax(0, milliseconds));
+}
+
 void OfficeLineEdit::keyPressEvent(QKeyEvent* event)
 {
     // The backspace should always be enabled, regardless of the current
@@ -129,11 +159,47 @@ void OfficeLineEdit::generateEvent()
         // emit an event before the user has typed.
         m_previous = text();
     }
+    else if (m_timer->interval() > 0)
+    {
+        // Restarts the quiet period; the change is reported by flushEvent.
+        m_timer->start();
+    }
     else
     {
-        auto current = text();
-        emit contentChanged(m_previous, current);
+        flushEvent();
+    }
+}
+
+void OfficeLineEdit::flushEvent()
+{
+    m_timer->stop();
 
-        m_previous = current;
+    const QString current = text();
+    if (current == m_previous)
+    {
+        // Either nothing is pending or the changes cancelled each other out.
+        return;
     }
+
+    // Strips the common prefix and suffix; what remains is the edit.
+    const int length = qMin(m_previous.size(), current.size());
+    int prefix = 0;
+    int suffix = 0;
+
+    while (prefix < length && m_previous.at(prefix) == current.at(prefix))
+        prefix++;
+    while (suffix < length - prefix &&
+           m_previous.at(m_previous.size() - suffix - 1) ==
+           current.at(current.size() - suffix - 1))
+        suffix++;
+
+    emit contentEdited(
+        prefix,
+        m_previous.size() - prefix - suffix,
+        current.mid(prefix, current.size() - prefix - suffix)
+        );
+
+    emit contentChanged(m_previous, current);
+
+    m_previous = current;
 }
@@ -29,13 +29,21 @@
 
 #include <QApplication>
 #include <QBoxLayout>
+#include <QLayout>
 #include <QMouseEvent>
 #include <QPainter>
+#include <QTimer>
 
 static QOFFICE_CONSTEXPR int c_collapsedHeight = 30;
 static QOFFICE_CONSTEXPR int c_expandedHeight = 120;
 static QOFFICE_CONSTEXPR Qt::Alignment c_flags = Qt::AlignLeft | Qt::AlignTop | Qt::AlignHCenter;
 
+static quint64 routingKey(OfficeMenuEvent::Type type, int itemId)
+{
+    return (static_cast<quint64>(static_cast<quint32>(type)) << 32) |
+            static_cast<quint32>(itemId);
+}
+
 OfficeMenu::OfficeMenu(QWidget* parent)
     : QWidget(parent)
     , m_headerLayout(new QHBoxLayout)
@@ -43,6 +51,8 @@ OfficeMenu::OfficeMenu(QWidget* parent)
     , m_isExpanded(false)
     , m_isPinned(false)
     , m_isTooltipShown(false)
+    , m_updateDepth(0)
+    , m_nextSubscription(0)
 {
     QVBoxLayout* container = new QVBoxLayout(this);
     container->setContentsMargins(0,0,0,0);
@@ -64,18 +74,35 @@ OfficeMenu::OfficeMenu(QWidget* parent)
     setLayout(container);
 
     setFocusPolicy(Qt::ClickFocus);
-    setProperty("qoffice_menu", true);
+
+    // Collapses the menu once the focus leaves it. A single subscription per
+    // menu replaces an event filter on every panel bar and item widget.
+    m_ownedWidgets.insert(this);
+    QObject::connect(
+        qApp, &QApplication::focusChanged,
+        this, &OfficeMenu::onFocusChanged
+        );
+
+    // Required for queued connections to OfficeMenu::sharedItemEvent.
+    qRegisterMetaType<OfficeMenuEventHandle>();
 }
 
-OfficeMenuHeader* OfficeMenu::headerById(int id) const
+OfficeMenu::~OfficeMenu()
 {
-    for (auto* header : m_headers)
+    // Destroys the headers while the menu is still intact, since they remove
+    // their panel bars from it. Deleting a focused item must not collapse the
+    // menu in the meantime.
+    QObject::disconnect(qApp, nullptr, this, nullptr);
+
+    while (!m_headers.isEmpty())
     {
-        if (header->id() == id)
-            return header;
+        delete m_headers.takeLast();
     }
+}
 
-    return nullptr;
+OfficeMenuHeader* OfficeMenu::headerById(int id) const
+{
+    return m_headerIndex.value(id, nullptr);
 }
 
 OfficeMenuItem* OfficeMenu::itemById(int headerId, int panelId, int itemId) const
@@ -94,14 +121,9 @@ OfficeMenuItem* OfficeMenu::itemById(int headerId, int panelId, int itemId) cons
     }
     else
     {
-        // The user requested a dynamic search (sigh).
-        for (auto* header : m_headers)
-        for (auto* panel : header->m_panels)
-        for (auto* item : panel->m_items)
-        {
-            if (item->id() == itemId)
-                return item;
-        }
+        // The user requested a dynamic search. Every panel registers its items
+        // in the menu-wide index, so there is no need to walk the hierarchy.
+        return m_itemIndex.value(itemId, nullptr);
     }
 
     return nullptr;
@@ -117,6 +139,11 @@ bool OfficeMenu::isPinned() const
     return m_isPinned;
 }
 
+bool OfficeMenu::isUpdating() const
+{
+    return m_updateDepth > 0;
+}
+
 void OfficeMenu::setPinned(bool pinned, bool c)
 {
     m_isPinned = pinned;
@@ -137,7 +164,7 @@ OfficeMenuHeader* OfficeMenu::insertHeader(int pos, int id, const QString& text)
 {
     // Ensures that no item with the given ID already exists. We need to have
     // unique IDs, otherwise we are not able to safely track item events.
-    if (headerById(id) != nullptr)
+    if (m_headerIndex.contains(id))
     {
         return nullptr;
     }
@@ -154,6 +181,8 @@ OfficeMenuHeader* OfficeMenu::insertHeader(int pos, int id, const QString& text)
     header->show();
 
     m_headers.insert(pos, header);
+    m_headerIndex.insert(id, header);
+    m_searchIndex.insert(text, header);
     m_headerLayout->insertWidget(pos, header, 0, c_flags);
 
     return header;
@@ -165,8 +194,13 @@ bool OfficeMenu::removeHeader(int id)
     if (header != nullptr)
     {
         m_headers.removeOne(header);
+        m_headerIndex.remove(id);
+        m_searchIndex.remove(header);
         m_headerLayout->removeWidget(header);
 
+        for (auto* panel : header->m_panels)
+            unindexPanel(panel);
+
         delete header;
     }
 
@@ -175,6 +209,8 @@ bool OfficeMenu::removeHeader(int id)
 
 void OfficeMenu::expand(OfficeMenuHeader* toExpand)
 {
+    OffTraceScope("OfficeMenu::expand");
+
     if (toExpand != nullptr)
     {
         // Collapses any other open headers.
@@ -200,6 +236,8 @@ void OfficeMenu::expand(OfficeMenuHeader* toExpand)
 
 void OfficeMenu::collapse()
 {
+    OffTraceScope("OfficeMenu::collapse");
+
     // Collapses all headers.
     for (auto* header : m_headers)
     {
@@ -209,6 +247,159 @@ void OfficeMenu::collapse()
     m_isExpanded = false;
 }
 
+void OfficeMenu::prebuild()
+{
+    for (auto* header : m_headers)
+    {
+        if (!header->isMaterialized())
+        {
+            // Builds only one header at a time, so that input and paint events
+            // are still processed in between.
+            QTimer::singleShot(0, header, [this, header]()
+                {
+                    header->materialize();
+                    prebuild();
+                });
+
+            return;
+        }
+    }
+}
+
+void OfficeMenu::beginUpdate()
+{
+    if (m_updateDepth++ > 0)
+    {
+        return;
+    }
+
+    // Disabled layouts ignore activation requests, hence none of the insertions
+    // or removals in between computes any geometry. Headers and panels that
+    // are created during the batch are suspended through suspendLayout. Only
+    // layouts that are enabled right now are suspended and restored later.
+    for (auto* layout : findChildren<QLayout*>())
+    {
+        suspendLayout(layout);
+    }
+
+    // Popups are windows of their own and do not inherit the updates flag of
+    // the menu, hence they are suspended one by one.
+    for (auto* widget : findChildren<QWidget*>())
+    {
+        if (widget->isWindow() && widget->updatesEnabled())
+        {
+            widget->setUpdatesEnabled(false);
+            m_suspendedWindows.append(widget);
+        }
+    }
+
+    setUpdatesEnabled(false);
+}
+
+void OfficeMenu::endUpdate()
+{
+    if (m_updateDepth == 0 || --m_updateDepth > 0)
+    {
+        return;
+    }
+
+    OffTraceScope("OfficeMenu::endUpdate");
+
+    // Layouts that were disabled before the batch stay disabled. Layouts and
+    // popups that were deleted in between are skipped.
+    for (const auto& layout : m_suspendedLayouts)
+    {
+        if (layout != nullptr)
+            layout->setEnabled(true);
+    }
+
+    m_suspendedLayouts.clear();
+
+    // Lays out everything that is visible in one pass. Hidden panel bars are
+    // laid out once they are shown.
+    layout()->activate();
+    for (auto* header : m_headers)
+    {
+        if (header->isSelected() && header->m_panelBar != nullptr)
+        {
+            header->m_panelBar->layout()->activate();
+        }
+    }
+
+    for (const auto& window : m_suspendedWindows)
+    {
+        if (window != nullptr)
+            window->setUpdatesEnabled(true);
+    }
+
+    m_suspendedWindows.clear();
+
+    setUpdatesEnabled(true);
+    updateGeometry();
+}
+
+int OfficeMenu::subscribe(int itemId, OfficeMenuEvent::Type type, EventHandler handler)
+{
+    const int handle = m_nextSubscription++;
+    const quint64 key = routingKey(type, itemId);
+
+    m_subscriptions[key].append({ handle, std::move(handler) });
+    m_subscriptionKeys.insert(handle, key);
+
+    return handle;
+}
+
+bool OfficeMenu::unsubscribe(int handle)
+{
+    auto it = m_subscriptionKeys.find(handle);
+    if (it == m_subscriptionKeys.end())
+    {
+        return false;
+    }
+
+    auto route = m_subscriptions.find(it.value());
+    for (int i = 0; i < route->size(); i++)
+    {
+        if (route->at(i).handle == handle)
+        {
+            route->remove(i);
+            break;
+        }
+    }
+
+    if (route->isEmpty())
+    {
+        m_subscriptions.erase(route);
+    }
+
+    m_subscriptionKeys.erase(it);
+
+    return true;
+}
+
+QVector<OfficeMenuSearchIndex::Match> OfficeMenu::search(const QString& query, int limit)
+{
+    return m_searchIndex.search(query, limit);
+}
+
+void OfficeMenu::reveal(const OfficeMenuSearchIndex::Match& match)
+{
+    if (match.header == nullptr)
+    {
+        return;
+    }
+
+    if (!match.header->isSelected())
+    {
+        expand(match.header);
+    }
+
+    if (match.item != nullptr && match.item->widget() != nullptr)
+    {
+        match.item->widget()->setFocus(Qt::OtherFocusReason);
+    }
+}
+
 QSize OfficeMenu::sizeHint() const
 {
     return QSize(parentWidget()->width(), height());
@@ -221,54 +412,93 @@ void OfficeMenu::accentUpdateEvent()
 
 void OfficeMenu::paintEvent(QPaintEvent*)
 {
+    OffTraceScope("OfficeMenu::paint");
+
     QPainter painter(this);
     QRect background(0, 0, width(), c_collapsedHeight);
 
     painter.fillRect(background, OfficeAccent::color(accent()));
 }
 
-void OfficeMenu::focusOutEvent(QFocusEvent* event)
+void OfficeMenu::onFocusChanged(QWidget* old, QWidget* now)
 {
-    collapseOnFocusLost();
+    // Normally, the menu collapses when focusing any other widget than the
+    // menu. Many of the panel items are widgets that require focus, though
+    // (textbox, combobox, ...), hence moving the focus between the widgets of
+    // the menu must not collapse it.
+    if (m_isPinned || m_isTooltipShown || !isOwned(old) || isOwned(now))
+    {
+        return;
+    }
 
-    QWidget::focusOutEvent(event);
+    collapse();
 }
 
-bool OfficeMenu::eventFilter(QObject* obj, QEvent* event)
+bool OfficeMenu::isOwned(const QWidget* widget) const
 {
-    if (event->type() == QEvent::FocusOut)
+    // Item widgets and panel bars are looked up directly. Only widgets nested
+    // within them, e.g. the popup of a drop-down, walk up their parents.
+    for (; widget != nullptr; widget = widget->parentWidget())
     {
-        collapseOnFocusLost();
+        if (m_ownedWidgets.contains(widget))
+            return true;
+    }
+
+    return false;
+}
+
+void OfficeMenu::indexItem(OfficeMenuItem* item)
+{
+    m_itemIndex.insert(item->id(), item);
+    m_ownedWidgets.insert(item->widget());
 
-        return true;
+    if (!item->searchText().isEmpty())
+    {
+        auto* panel = item->panel();
+        m_searchIndex.insert(item->searchText(), panel->header(), panel, item);
     }
+}
+
+void OfficeMenu::unindexItem(OfficeMenuItem* item)
+{
+    // Only removes this very item; other panels may use the same ID.
+    m_itemIndex.remove(item->id(), item);
+    m_ownedWidgets.remove(item->widget());
+    m_searchIndex.remove(item);
+}
 
-    return QObject::eventFilter(obj, event);
+void OfficeMenu::unindexPanel(OfficeMenuPanel* panel)
+{
+    for (auto* item : panel->m_items)
+        unindexItem(item);
+
+    m_searchIndex.remove(panel);
 }
 
-void OfficeMenu::collapseOnFocusLost()
+void OfficeMenu::suspendLayout(QLayout* layout)
 {
-    bool focusOverride = false;
-
-    // Hack: Normally, the menu collapses when focusing any other widget than
-    // the menu. This is not always desired, though, since many of the panel
-    // items are widgets that require focus (textbox, combobox, ...). Widgets
-    // that define 'qoffice_menu_item=true' through their properties are
-    // whitelisted by the OfficeMenu and will not cause it to collapse.
-    auto* focus = QApplication::focusWidget();
-    if (focus != nullptr)
+    if (m_updateDepth > 0 && layout->isEnabled())
     {
-        if (focus->property("qoffice_menu_item").toBool() ||
-            focus->property("qoffice_menu").toBool())
-        {
-            focusOverride = true;
-        }
+        layout->setEnabled(false);
+        m_suspendedLayouts.append(layout);
     }
+}
 
-    if (!focusOverride && !m_isPinned && !m_isTooltipShown)
+void OfficeMenu::dispatchEvent(OfficeMenuEvent* event)
+{
+    auto route = m_subscriptions.constFind(routingKey(event->type(), event->id()));
+    if (route != m_subscriptions.constEnd())
     {
-        // If the ribbon is not pinned, it should collapse when we focus a
-        // different widget with our mouse.
-        collapse();
+        // Iterates a copy, since handlers may (un)subscribe while being called.
+        // Handlers subscribed meanwhile wait for the next event; handlers
+        // unsubscribed meanwhile are not called anymore.
+        const QVector<Subscription> subscriptions = route.value();
+        for (const auto& subscription : subscriptions)
+        {
+            if (m_subscriptionKeys.contains(subscription.handle))
+            {
+                subscription.handler(event);
+            }
+        }
     }
 }
@@ -0,0 +1,277 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// QOffice - The office framework for Qt
+// Copyright (C) 2016-2018 Nicolas Kogler
+//
+// This file is part of the Widget module.
+//
+// QOffice is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// QOffice is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with QOffice. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QOffice/Widgets/OfficeMenu.hpp>
+#include <QOffice/Widgets/OfficeMenuCommandExecutor.hpp>
+#include <QOffice/Widgets/OfficeMenuItem.hpp>
+
+#include <QRunnable>
+#include <QWidget>
+
+namespace priv
+{
+class CommandRunnable : public QRunnable
+{
+public:
+
+    CommandRunnable(std::function<void()> function)
+        : m_function(std::move(function))
+    {
+    }
+
+    void run() override
+    {
+        m_function();
+    }
+
+private:
+
+    std::function<void()> m_function;
+};
+}
+
+OfficeMenuCommandExecutor::OfficeMenuCommandExecutor(OfficeMenu* menu)
+    : QObject(menu)
+    , m_menu(menu)
+{
+    QObject::connect(
+        menu, &OfficeMenu::sharedItemEvent,
+        this, &OfficeMenuCommandExecutor::onItemEvent
+        );
+}
+
+OfficeMenuCommandExecutor::~OfficeMenuCommandExecutor()
+{
+    // Results that arrive after this point are discarded along with the
+    // queued calls to this object.
+    for (auto& entry : m_commands)
+    {
+        if (entry.isRunning)
+        {
+            entry.cancelled->store(true);
+        }
+    }
+
+    m_pool.waitForDone();
+}
+
+QThreadPool* OfficeMenuCommandExecutor::threadPool()
+{
+    return &m_pool;
+}
+
+void OfficeMenuCommandExecutor::registerCommand(
+    int itemId,
+    OfficeMenuEvent::Type type,
+    Command command,
+    TriggerPolicy policy
+    )
+{
+    auto it = m_commands.find(itemId);
+    if (it != m_commands.end())
+    {
+        // A run of the previous command may still be on the pool; keeping its
+        // state makes the next trigger wait for it like for any other run.
+        it->command = std::move(command);
+        it->type = type;
+        it->policy = policy;
+        return;
+    }
+
+    Entry entry;
+    entry.command = std::move(command);
+    entry.type = type;
+    entry.policy = policy;
+    entry.isRunning = false;
+
+    m_commands.insert(itemId, entry);
+}
+
+bool OfficeMenuCommandExecutor::unregisterCommand(int itemId)
+{
+    auto it = m_commands.find(itemId);
+    if (it == m_commands.end())
+    {
+        return false;
+    }
+
+    const bool wasRunning = it->isRunning;
+    if (wasRunning)
+    {
+        it->cancelled->store(true);
+    }
+
+    m_commands.erase(it);
+
+    if (wasRunning)
+    {
+        setBusy(itemId, false);
+    }
+
+    return true;
+}
+
+void OfficeMenuCommandExecutor::cancel(int itemId)
+{
+    auto it = m_commands.find(itemId);
+    if (it != m_commands.end() && it->isRunning)
+    {
+        it->cancelled->store(true);
+        it->pending = OfficeMenuEventHandle();
+    }
+}
+
+bool OfficeMenuCommandExecutor::isBusy(int itemId) const
+{
+    auto it = m_commands.find(itemId);
+    return it != m_commands.end() && it->isRunning;
+}
+
+void OfficeMenuCommandExecutor::onItemEvent(OfficeMenuEventHandle event)
+{
+    auto it = m_commands.find(event->id());
+    if (it == m_commands.end())
+    {
+        return;
+    }
+
+    if (it->type != OfficeMenuEvent::Invalid && it->type != event->type())
+    {
+        return;
+    }
+
+    if (!it->isRunning)
+    {
+        start(event->id(), *it, event);
+        setBusy(event->id(), true);
+        return;
+    }
+
+    // Commands of the same item never run concurrently. Repeated triggers
+    // collapse into a single pending one, so that e.g. typing a word only
+    // runs the command for the first and the last keystroke.
+    switch (it->policy)
+    {
+    case RestartLatest:
+        it->cancelled->store(true);
+        it->pending = event;
+        break;
+
+    case QueueLatest:
+        it->pending = event;
+        break;
+
+    case IgnoreWhileBusy:
+        break;
+    }
+}
+
+void OfficeMenuCommandExecutor::start(
+    int itemId,
+    Entry& entry,
+    const OfficeMenuEventHandle& event
+    )
+{
+    OffTraceScope("OfficeMenuCommandExecutor::start");
+
+    // Each run gets its own token; a stale run can therefore never cancel or
+    // complete the run that replaced it.
+    auto token = std::make_shared<std::atomic<bool>>(false);
+    auto command = entry.command;
+
+    entry.cancelled = token;
+    entry.isRunning = true;
+
+    m_pool.start(new priv::CommandRunnable([this, itemId, token, command, event]()
+        {
+            const QVariant result = command(event, *token);
+
+            QMetaObject::invokeMethod(this, [this, itemId, token, result]()
+                {
+                    finish(itemId, token, result);
+                },
+                Qt::QueuedConnection
+                );
+        }));
+}
+
+void OfficeMenuCommandExecutor::finish(
+    int itemId,
+    const std::shared_ptr<std::atomic<bool>>& token,
+    const QVariant& result
+    )
+{
+    auto it = m_commands.find(itemId);
+    if (it == m_commands.end() || it->cancelled != token)
+    {
+        // The command was unregistered or replaced in the meantime.
+        emit commandCancelled(itemId);
+        return;
+    }
+
+    const bool wasCancelled = token->load();
+    const bool hasPending = !it->pending.isNull();
+
+    // Updates the state before emitting anything, since receivers may
+    // register or unregister commands themselves.
+    if (hasPending)
+    {
+        OfficeMenuEventHandle event = it->pending;
+        it->pending = OfficeMenuEventHandle();
+        start(itemId, *it, event);
+    }
+    else
+    {
+        it->isRunning = false;
+    }
+
+    if (wasCancelled)
+    {
+        emit commandCancelled(itemId);
+    }
+    else
+    {
+        emit commandFinished(itemId, result);
+    }
+
+    if (!hasPending)
+    {
+        setBusy(itemId, false);
+    }
+}
+
+void OfficeMenuCommandExecutor::setBusy(int itemId, bool busy)
+{
+    OfficeMenuItem* item = m_menu->itemById(-1, -1, itemId);
+    if (item != nullptr && item->widget() != nullptr)
+    {
+        QWidget* widget = item->widget();
+        widget->setProperty("qoffice_busy", busy);
+
+        if (busy)
+            widget->setCursor(Qt::BusyCursor);
+        else
+            widget->unsetCursor();
+    }
+
+    emit busyChanged(itemId, busy);
+}
@@ -25,6 +25,8 @@
 OfficeMenuEvent::OfficeMenuEvent(Type type, int id)
     : m_type(type)
     , m_id(id)
+    , m_accepted(true)
+    , m_isShared(false)
 {
 }
 
@@ -45,12 +47,18 @@ bool OfficeMenuEvent::isAccepted() const
 
 void OfficeMenuEvent::accept()
 {
-    m_accepted = true;
+    if (!m_isShared)
+    {
+        m_accepted = true;
+    }
 }
 
 void OfficeMenuEvent::ignore()
 {
-    m_accepted = false;
+    if (!m_isShared)
+    {
+        m_accepted = false;
+    }
 }
 
 OfficeMenuTextChangedEvent::OfficeMenuTextChangedEvent(
@@ -119,3 +127,30 @@ QVariant OfficeMenuItemChangedEvent::value() const
 {
     return m_value;
 }
+
+OfficeMenuTextEditedEvent::OfficeMenuTextEditedEvent(
+    int id,
+    int position,
+    int removed,
+    const QString &inserted
+    ) : OfficeMenuEvent(OfficeMenuEvent::TextEdited, id)
+      , m_position(position)
+      , m_removed(removed)
+      , m_inserted(inserted)
+{
+}
+
+int OfficeMenuTextEditedEvent::position() const
+{
+    return m_position;
+}
+
+int OfficeMenuTextEditedEvent::removedLength() const
+{
+    return m_removed;
+}
+
+const QString& OfficeMenuTextEditedEvent::insertedText() const
+{
+    return m_inserted;
+}
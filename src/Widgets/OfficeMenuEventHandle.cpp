@@ -0,0 +1,88 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// QOffice - The office framework for Qt
+// Copyright (C) 2016-2018 Nicolas Kogler
+//
+// This file is part of the Widget module.
+//
+// QOffice is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// QOffice is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with QOffice. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QOffice/Widgets/OfficeMenuEventHandle.hpp>
+
+OfficeMenuEventHandle::OfficeMenuEventHandle()
+    : m_block(nullptr)
+{
+}
+
+OfficeMenuEventHandle::OfficeMenuEventHandle(priv::EventBlock* block)
+    : m_block(block)
+{
+    // Freezes the event before it can reach any other thread.
+    m_block->event->m_isShared = true;
+}
+
+OfficeMenuEventHandle::OfficeMenuEventHandle(const OfficeMenuEventHandle& handle)
+    : m_block(handle.m_block)
+{
+    if (m_block != nullptr)
+    {
+        m_block->refs.ref();
+    }
+}
+
+OfficeMenuEventHandle::OfficeMenuEventHandle(OfficeMenuEventHandle&& handle)
+    : m_block(handle.m_block)
+{
+    handle.m_block = nullptr;
+}
+
+OfficeMenuEventHandle::~OfficeMenuEventHandle()
+{
+    if (m_block != nullptr && !m_block->refs.deref())
+    {
+        m_block->recycle(m_block);
+    }
+}
+
+OfficeMenuEventHandle& OfficeMenuEventHandle::operator =(const OfficeMenuEventHandle& handle)
+{
+    OfficeMenuEventHandle copy(handle);
+    std::swap(m_block, copy.m_block);
+
+    return *this;
+}
+
+OfficeMenuEventHandle& OfficeMenuEventHandle::operator =(OfficeMenuEventHandle&& handle)
+{
+    std::swap(m_block, handle.m_block);
+
+    return *this;
+}
+
+bool OfficeMenuEventHandle::isNull() const
+{
+    return m_block == nullptr;
+}
+
+const OfficeMenuEvent* OfficeMenuEventHandle::event() const
+{
+    return m_block != nullptr ? m_block->event : nullptr;
+}
+
+const OfficeMenuEvent* OfficeMenuEventHandle::operator ->() const
+{
+    return event();
+}
@@ -24,14 +24,15 @@
 #include <QOffice/Design/OfficePalette.hpp>
 #include <QOffice/Widgets/OfficeMenu.hpp>
 #include <QOffice/Widgets/OfficeMenuHeader.hpp>
+#include <QOffice/Widgets/OfficeMenuItem.hpp>
 #include <QOffice/Widgets/OfficeMenuPanel.hpp>
 #include <QOffice/Widgets/OfficeMenuPanelBar.hpp>
 #include <QOffice/Widgets/OfficeMenuPinButton.hpp>
 
-#include <QGraphicsEffect>
 #include <QHBoxLayout>
 #include <QMouseEvent>
 #include <QPainter>
+#include <QPropertyAnimation>
 
 static QOFFICE_CONSTEXPR int c_headerHeight = 30;
 static QOFFICE_CONSTEXPR int c_panelHeight  = 90;
@@ -41,63 +42,34 @@ static QOFFICE_CONSTEXPR int c_space = 10000;
 OfficeMenuHeader::OfficeMenuHeader(OfficeMenu* parent)
     : QWidget(parent)
     , m_parent(parent)
-    , m_panelBar(new priv::PanelBar(parent))
-    , m_panelLayout(new QHBoxLayout)
-    , m_effectIn(new QGraphicsOpacityEffect(m_panelBar))
-    , m_animationIn(new QPropertyAnimation(m_panelBar, "size"))
-    , m_animationOut(new QPropertyAnimation(m_panelBar, "size"))
+    , m_panelBar(nullptr)
+    , m_snapshot(nullptr)
+    , m_panelLayout(nullptr)
+    , m_animationIn(nullptr)
+    , m_animationOut(nullptr)
     , m_text("Header")
     , m_isHovered(false)
     , m_isSelected(false)
     , m_id(-1)
 {
-    // Split the layout up into two separate layouts. This is needed for the
-    // sticky button to always stay on the bottom right.
-    QHBoxLayout* stickyLayout = new QHBoxLayout;
-    stickyLayout->setSpacing(2);
-    stickyLayout->setMargin(0);
-    stickyLayout->setContentsMargins(0,0,0,0);
-
-    // Put the sticky button into a separate layout.
-    QHBoxLayout* buttonLayout = new QHBoxLayout;
-    buttonLayout->setMargin(0);
-    buttonLayout->setContentsMargins(0,0,0,0);
-    buttonLayout->setSizeConstraint(QLayout::SetFixedSize);
-    buttonLayout->addWidget(new priv::PinButton(this), 0, Qt::AlignBottom);
-
-    QSpacerItem* spacer = new QSpacerItem(
-        c_space, 0,
-        QSizePolicy::Expanding,
-        QSizePolicy::Expanding
-        );
-
-    m_panelBar->hide();
-    m_panelBar->setGraphicsEffect(m_effectIn);
-    m_panelBar->setAutoFillBackground(true);
-    m_panelBar->setLayout(stickyLayout);
-    m_panelBar->resize(0, 0);
-
-    m_panelLayout->setSpacing(4);
-    m_panelLayout->setContentsMargins(0,0,0,0);
-    m_panelLayout->setSizeConstraint(QLayout::SetMaximumSize);
-
-    stickyLayout->addLayout(m_panelLayout);
-    stickyLayout->addSpacerItem(spacer);
-    stickyLayout->addLayout(buttonLayout);
-
-    QObject::connect(
-        m_animationIn,
-        &QPropertyAnimation::finished,
-        this,
-        &OfficeMenuHeader::animationInFinished
-        );
+    // The panel bar is built by OfficeMenuHeader::materialize, either once the
+    // first panel is inserted or once this header is expanded.
+}
 
-    QObject::connect(
-        m_animationOut,
-        &QPropertyAnimation::finished,
-        this,
-        &OfficeMenuHeader::animationOutFinished
-        );
+OfficeMenuHeader::~OfficeMenuHeader()
+{
+    // The panel bar and its snapshot are children of the menu, hence they
+    // would outlive this header. The animations go first; they target the
+    // snapshot and would otherwise report finishing to this header.
+    delete m_animationIn;
+    delete m_animationOut;
+    delete m_snapshot;
+
+    if (m_panelBar != nullptr)
+    {
+        m_parent->m_ownedWidgets.remove(m_panelBar);
+        delete m_panelBar;
+    }
 }
 
 int OfficeMenuHeader::id() const
@@ -122,13 +94,7 @@ OfficeMenu* OfficeMenuHeader::menu() const
 
 OfficeMenuPanel* OfficeMenuHeader::panelById(int id) const
 {
-    for (auto* panel : m_panels)
-    {
-        if (panel->id() == id)
-            return panel;
-    }
-
-    return nullptr;
+    return m_panelIndex.value(id, nullptr);
 }
 
 OfficeMenuPanel* OfficeMenuHeader::operator [](int id) const
@@ -136,14 +102,34 @@ OfficeMenuPanel* OfficeMenuHeader::operator [](int id) const
     return panelById(id);
 }
 
-void OfficeMenuHeader::setId(int id)
+bool OfficeMenuHeader::isMaterialized() const
+{
+    return m_panelBar != nullptr;
+}
+
+bool OfficeMenuHeader::setId(int id)
 {
+    // Re-keys the lookup table of the menu if this header is registered. The
+    // entry of another header with the same ID is never overwritten.
+    if (m_parent != nullptr && m_parent->m_headerIndex.value(m_id) == this)
+    {
+        if (id != m_id && m_parent->m_headerIndex.contains(id))
+        {
+            return false;
+        }
+
+        m_parent->m_headerIndex.remove(m_id);
+        m_parent->m_headerIndex.insert(id, this);
+    }
+
     m_id = id;
+    return true;
 }
 
 void OfficeMenuHeader::setText(const QString& text)
 {
     m_text = text;
+    m_parent->m_searchIndex.update(this, text);
 }
 
 OfficeMenuPanel* OfficeMenuHeader::appendPanel(int id, const QString& text)
@@ -153,9 +139,12 @@ OfficeMenuPanel* OfficeMenuHeader::appendPanel(int id, const QString& text)
 
 OfficeMenuPanel* OfficeMenuHeader::insertPanel(int pos, int id, const QString& text)
 {
+    // Builds the declared panels first, so that their IDs are indexed.
+    materialize();
+
     // Ensures that no item with the given ID already exists. We need to have
     // unique IDs, otherwise we are not able to safely track item events.
-    if (panelById(id) != nullptr)
+    if (m_panelIndex.contains(id))
     {
         return nullptr;
     }
@@ -167,12 +156,16 @@ OfficeMenuPanel* OfficeMenuHeader::insertPanel(int pos, int id, const QString& t
     }
 
     OfficeMenuPanel* panel = new OfficeMenuPanel(m_panelBar, this);
+    m_parent->suspendLayout(panel->layout());
     panel->setText(text);
     panel->setId(id);
     panel->show();
 
     m_panels.insert(pos, panel);
+    m_panelIndex.insert(id, panel);
+    m_parent->m_searchIndex.insert(text, this, panel);
     m_panelLayout->insertWidget(pos, panel, 0);
+    m_panelBar->invalidate();
 
     return panel;
 }
@@ -183,7 +176,10 @@ bool OfficeMenuHeader::removePanel(int id)
     if (panel != nullptr)
     {
         m_panels.removeOne(panel);
+        m_panelIndex.remove(id);
+        m_panelBar->release(panel);
         m_panelLayout->removeWidget(panel);
+        m_parent->unindexPanel(panel);
 
         delete panel;
     }
@@ -191,6 +187,105 @@ bool OfficeMenuHeader::removePanel(int id)
     return panel != nullptr;
 }
 
+bool OfficeMenuHeader::declarePanel(int id, const QString& text)
+{
+    if (isMaterialized())
+    {
+        return appendPanel(id, text) != nullptr;
+    }
+
+    for (const auto& declaration : m_declaredPanels)
+    {
+        if (declaration.id == id)
+            return false;
+    }
+
+    m_declaredPanels.append({ id, text, {} });
+
+    return true;
+}
+
+bool OfficeMenuHeader::declareItem(
+    int panelId, int id,
+    std::function<OfficeMenuItem*()> factory,
+    int row, int column,
+    int rowSpan, int columnSpan
+    )
+{
+    if (isMaterialized())
+    {
+        auto* panel = panelById(panelId);
+        if (panel == nullptr || panel->itemById(id) != nullptr)
+        {
+            return false;
+        }
+
+        auto* item = factory();
+        if (item == nullptr || !panel->insertItem(id, item, row, column, rowSpan, columnSpan))
+        {
+            delete item;
+            return false;
+        }
+
+        return true;
+    }
+
+    for (auto& declaration : m_declaredPanels)
+    {
+        if (declaration.id != panelId)
+            continue;
+
+        for (const auto& itemDeclaration : declaration.items)
+        {
+            if (itemDeclaration.id == id)
+                return false;
+        }
+
+        declaration.items.append({
+            id, std::move(factory),
+            row, column,
+            rowSpan, columnSpan
+            });
+
+        return true;
+    }
+
+    return false;
+}
+
+void OfficeMenuHeader::materialize()
+{
+    if (isMaterialized())
+    {
+        return;
+    }
+
+    OffTraceScope("OfficeMenuHeader::materialize");
+
+    createPanelBar();
+
+    // Swaps the declarations out first; insertPanel would otherwise see them.
+    QList<priv::PanelDeclaration> declarations;
+    declarations.swap(m_declaredPanels);
+
+    for (const auto& declaration : declarations)
+    {
+        auto* panel = appendPanel(declaration.id, declaration.text);
+        for (const auto& itemDeclaration : declaration.items)
+        {
+            auto* item = itemDeclaration.factory();
+            bool inserted = item != nullptr && panel->insertItem(
+                itemDeclaration.id, item,
+                itemDeclaration.row, itemDeclaration.column,
+                itemDeclaration.rowSpan, itemDeclaration.columnSpan
+                );
+
+            if (!inserted)
+                delete item;
+        }
+    }
+}
+
 QSize OfficeMenuHeader::sizeHint() const
 {
     return QSize(fontMetrics().width(m_text) + c_textPadding, c_headerHeight);
@@ -198,6 +293,8 @@ QSize OfficeMenuHeader::sizeHint() const
 
 void OfficeMenuHeader::paintEvent(QPaintEvent*)
 {
+    OffTraceScope("OfficeMenuHeader::paint");
+
     QPainter painter(this);
 
     const QColor& colorAccent = OfficeAccent::color(m_parent->accent());
@@ -252,37 +349,100 @@ void OfficeMenuHeader::mousePressEvent(QMouseEvent* event)
 
 void OfficeMenuHeader::animationInFinished()
 {
+    // Swaps the live widgets in, now that the reveal is complete.
+    m_panelBar->show();
+    stopSnapshot();
 }
 
 void OfficeMenuHeader::animationOutFinished()
 {
+    stopSnapshot();
+
     m_parent->resize(width(), c_headerHeight);
     m_parent->setFixedHeight(c_headerHeight);
 }
 
+void OfficeMenuHeader::createPanelBar()
+{
+    m_panelBar = new priv::PanelBar(m_parent, this);
+    m_parent->m_ownedWidgets.insert(m_panelBar);
+    m_panelLayout = new QHBoxLayout;
+    m_snapshot = new priv::PanelBarSnapshot(m_parent);
+    m_animationIn = new QPropertyAnimation(m_snapshot, "size", this);
+    m_animationOut = new QPropertyAnimation(m_snapshot, "size", this);
+
+    // Split the layout up into two separate layouts. This is needed for the
+    // sticky button to always stay on the bottom right.
+    QHBoxLayout* stickyLayout = new QHBoxLayout;
+    stickyLayout->setSpacing(2);
+    stickyLayout->setMargin(0);
+    stickyLayout->setContentsMargins(0,0,0,0);
+
+    // Put the sticky button into a separate layout.
+    QHBoxLayout* buttonLayout = new QHBoxLayout;
+    buttonLayout->setMargin(0);
+    buttonLayout->setContentsMargins(0,0,0,0);
+    buttonLayout->setSizeConstraint(QLayout::SetFixedSize);
+    buttonLayout->addWidget(new priv::PinButton(this), 0, Qt::AlignBottom);
+
+    QSpacerItem* spacer = new QSpacerItem(
+        c_space, 0,
+        QSizePolicy::Expanding,
+        QSizePolicy::Expanding
+        );
+
+    m_panelBar->hide();
+    m_panelBar->setAutoFillBackground(true);
+    m_panelBar->setLayout(stickyLayout);
+    m_panelBar->resize(0, 0);
+
+    m_panelLayout->setSpacing(4);
+    m_panelLayout->setContentsMargins(0,0,0,0);
+    m_panelLayout->setSizeConstraint(QLayout::SetMaximumSize);
+
+    stickyLayout->addLayout(m_panelLayout);
+    stickyLayout->addSpacerItem(spacer);
+    stickyLayout->addLayout(buttonLayout);
+
+    m_parent->suspendLayout(stickyLayout);
+
+    QObject::connect(
+        m_animationIn,
+        &QPropertyAnimation::finished,
+        this,
+        &OfficeMenuHeader::animationInFinished
+        );
+
+    QObject::connect(
+        m_animationOut,
+        &QPropertyAnimation::finished,
+        this,
+        &OfficeMenuHeader::animationOutFinished
+        );
+}
+
 void OfficeMenuHeader::expand(QHBoxLayout* panel, bool isExpanded)
 {
+    OffTraceScope("OfficeMenuHeader::animateExpand");
+
+    materialize();
+
     panel->addWidget(m_panelBar, 0, Qt::AlignLeft);
 
+    stopSnapshot();
+
     if (!isExpanded)
     {
-        // Huge hack: QWidget::show appearantly resizes the widget immediately,
-        // no matter what I do. Even explicit calls to QWidget::resize or
-        // QWidget::updateGeometry failed. This behaviour caused the widget to
-        // be visible at full height for a split second, before the QProperty-
-        // Animation kicked in and changed the QWidget::height to zero.
-        m_effectIn->setOpacity(0.0);
-        m_panelBar->show();
-
-        // This undesirable effect can only be eliminated by hiding the widget
-        // visually (via QGraphicsOpacityEffect) for a split second, too.
-        QTimer::singleShot(100, [&]() { m_effectIn->setOpacity(1.0); });
-
-        // The menu is not pinned yet, therefore show it using an animation.
-        m_animationIn->setDuration(200);
-        m_animationIn->setStartValue(QSize(m_parent->width(), 0));
-        m_animationIn->setEndValue(QSize(m_parent->width(), c_panelHeight));
-        m_animationIn->start();
+        // The menu is not pinned yet, therefore reveal it using an animation.
+        // The panel bar stays hidden until the animation finished; only its
+        // snapshot is animated, which avoids relayouting all the panels on
+        // every frame. Hidden widgets can be rendered just fine.
+        m_panelBar->resize(m_parent->width(), c_panelHeight);
+        m_panelBar->adapt();
+        m_panelBar->layout()->activate();
+        m_snapshot->setPixmap(m_panelBar->grab());
+
+        showSnapshot(m_animationIn, 0, c_panelHeight);
     }
     else
     {
@@ -295,21 +455,52 @@ void OfficeMenuHeader::expand(QHBoxLayout* panel, bool isExpanded)
     emit headerExpanded();
 }
 
+void OfficeMenuHeader::showSnapshot(QPropertyAnimation* animation, int from, int to)
+{
+    // The panel bar is located right below the headers, spanning the menu.
+    m_snapshot->move(0, c_headerHeight);
+    m_snapshot->resize(m_parent->width(), from);
+    m_snapshot->raise();
+    m_snapshot->show();
+
+    animation->setDuration(200);
+    animation->setStartValue(QSize(m_parent->width(), from));
+    animation->setEndValue(QSize(m_parent->width(), to));
+    animation->start();
+}
+
+void OfficeMenuHeader::stopSnapshot()
+{
+    // Stopping does not emit QPropertyAnimation::finished.
+    m_animationIn->stop();
+    m_animationOut->stop();
+
+    m_snapshot->hide();
+    m_snapshot->setPixmap(QPixmap());
+}
+
 void OfficeMenuHeader::collapse(QHBoxLayout* panel, bool isExpanded)
 {
-    panel->removeWidget(m_panelBar);
+    OffTraceScope("OfficeMenuHeader::animateCollapse");
 
-    if (isExpanded && m_isSelected)
-    {
-        // Hides the menu using a smooth animation.
-        m_animationOut->setDuration(200);
-        m_animationOut->setStartValue(QSize(m_parent->width(), c_panelHeight));
-        m_animationOut->setEndValue(QSize(m_parent->width(), 0));
-        m_animationOut->start();
-    }
-    else
+    // A header that was never expanded has no panel bar to hide.
+    if (isMaterialized())
     {
-        m_panelBar->hide();
+        panel->removeWidget(m_panelBar);
+        stopSnapshot();
+
+        if (isExpanded && m_isSelected)
+        {
+            // Hides the menu using a smooth animation of the snapshot.
+            m_snapshot->setPixmap(m_panelBar->grab());
+            m_panelBar->hide();
+
+            showSnapshot(m_animationOut, c_panelHeight, 0);
+        }
+        else
+        {
+            m_panelBar->hide();
+        }
     }
 
     m_isSelected = false;
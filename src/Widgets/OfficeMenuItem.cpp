@@ -22,12 +22,19 @@
 
 #include <QOffice/Widgets/OfficeMenu.hpp>
 #include <QOffice/Widgets/OfficeMenuEvent.hpp>
+#include <QOffice/Widgets/OfficeMenuEventHandle.hpp>
 #include <QOffice/Widgets/OfficeMenuHeader.hpp>
 #include <QOffice/Widgets/OfficeMenuItem.hpp>
 #include <QOffice/Widgets/OfficeMenuPanel.hpp>
 
 #include <QApplication>
 
+OfficeMenuItem::OfficeMenuItem()
+    : m_parent(nullptr)
+    , m_id(-1)
+{
+}
+
 int OfficeMenuItem::id() const
 {
     return m_id;
@@ -38,9 +45,21 @@ OfficeMenuPanel* OfficeMenuItem::panel() const
     return m_parent;
 }
 
-void OfficeMenuItem::setId(int id)
+const QString& OfficeMenuItem::searchText() const
 {
+    return m_searchText;
+}
+
+bool OfficeMenuItem::setId(int id)
+{
+    // Keeps the lookup tables of the panel and the menu in sync.
+    if (m_parent != nullptr && m_id != id && !m_parent->reindexItem(this, id))
+    {
+        return false;
+    }
+
     m_id = id;
+    return true;
 }
 
 void OfficeMenuItem::setPanel(OfficeMenuPanel* panel)
@@ -48,6 +67,19 @@ void OfficeMenuItem::setPanel(OfficeMenuPanel* panel)
     m_parent = panel;
 }
 
+void OfficeMenuItem::setSearchText(const QString& text)
+{
+    m_searchText = text;
+
+    // Items are only indexed once they are inserted into a panel.
+    if (m_parent != nullptr && m_parent->itemById(m_id) == this)
+    {
+        OfficeMenu* menu = m_parent->header()->menu();
+        menu->unindexItem(this);
+        menu->indexItem(this);
+    }
+}
+
 void OfficeMenuItem::emitItemEvent(OfficeMenuEvent* event)
 {
     // Climbs up the hierarchy latter and forwards the event.
@@ -57,6 +89,10 @@ void OfficeMenuItem::emitItemEvent(OfficeMenuEvent* event)
     {
         OfficeMenu* menu = m_parent->header()->menu();
 
+        // Handlers subscribed to this very item and event type come first;
+        // the signals still reach every connected slot.
+        menu->dispatchEvent(event);
+
         if (event->type() == OfficeMenuEvent::TextChanged)
         {
             emit menu->textChangedEvent(
@@ -72,9 +108,29 @@ void OfficeMenuItem::emitItemEvent(OfficeMenuEvent* event)
             emit menu->itemChangedEvent(
                 static_cast<OfficeMenuItemChangedEvent*>(event));
         }
+        else if (event->type() == OfficeMenuEvent::TextEdited)
+        {
+            emit menu->textEditedEvent(
+                static_cast<OfficeMenuTextEditedEvent*>(event));
+        }
         else
         {
             emit m_parent->header()->menu()->itemEvent(event);
         }
     }
 }
+
+void OfficeMenuItem::emitItemEvent(const OfficeMenuEventHandle& event)
+{
+    // The signals take a mutable event, but a shared event ignores accept and
+    // ignore; synchronous handlers can therefore not race with receivers on
+    // other threads that already hold the handle.
+    emitItemEvent(const_cast<OfficeMenuEvent*>(event.event()));
+
+    if (m_parent != nullptr &&
+        m_parent->header() != nullptr &&
+        m_parent->header()->menu() != nullptr)
+    {
+        emit m_parent->header()->menu()->sharedItemEvent(event);
+    }
+}
@@ -0,0 +1,458 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// QOffice - The office framework for Qt
+// Copyright (C) 2016-2018 Nicolas Kogler
+//
+// This file is part of the Widget module.
+//
+// QOffice is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// QOffice is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with QOffice. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QOffice/Widgets/MenuItems/OfficeMenuDropdownItem.hpp>
+#include <QOffice/Widgets/MenuItems/OfficeMenuFontPickerItem.hpp>
+#include <QOffice/Widgets/MenuItems/OfficeMenuGalleryItem.hpp>
+#include <QOffice/Widgets/MenuItems/OfficeMenuTextboxItem.hpp>
+#include <QOffice/Widgets/OfficeMenu.hpp>
+#include <QOffice/Widgets/OfficeMenuHeader.hpp>
+#include <QOffice/Widgets/OfficeMenuItem.hpp>
+#include <QOffice/Widgets/OfficeMenuLoader.hpp>
+#include <QOffice/Widgets/OfficeMenuPanel.hpp>
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSet>
+#include <QStandardItemModel>
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+#include <QCborMap>
+#include <QCborValue>
+#endif
+
+#include <cmath>
+#include <limits>
+
+static bool readInt(const QJsonObject& object, const char* key, int fallback, int* value)
+{
+    const QJsonValue json = object.value(QLatin1String(key));
+    if (json.isUndefined())
+    {
+        *value = fallback;
+        return true;
+    }
+
+    // JSON only knows doubles; reject anything that is not a whole number.
+    const double number = json.toDouble();
+    if (!json.isDouble() || std::floor(number) != number ||
+        number < std::numeric_limits<int>::min() ||
+        number > std::numeric_limits<int>::max())
+    {
+        return false;
+    }
+
+    *value = static_cast<int>(number);
+    return true;
+}
+
+static QString childPath(const QString& path, const char* key, int index)
+{
+    return QString("%1.%2[%3]").arg(path).arg(key).arg(index);
+}
+
+OfficeMenuLoader::OfficeMenuLoader()
+    : m_timings()
+    , m_isLazy(false)
+{
+    registerItemType("textbox", [](const QJsonObject& object)
+        {
+            auto* item = new OfficeMenuTextboxItem(object.value("text").toString());
+            item->setCoalescePeriod(object.value("coalesce").toInt());
+
+            return item;
+        });
+
+    registerItemType("gallery", [](const QJsonObject& object)
+        {
+            auto* item = new OfficeMenuGalleryItem;
+            auto* model = new QStandardItemModel(item);
+
+            for (const auto& entryValue : object.value("entries").toArray())
+            {
+                const QJsonObject entry = entryValue.toObject();
+                auto* row = new QStandardItem(entry.value("text").toString());
+                row->setData(entry.value("thumbnail").toString(), OfficeMenuGalleryItem::ThumbnailRole);
+
+                if (entry.contains("value"))
+                    row->setData(entry.value("value").toVariant(), OfficeMenuGalleryItem::ValueRole);
+
+                model->appendRow(row);
+            }
+
+            const int size = object.value("thumbnailSize").toInt();
+            if (size > 0)
+            {
+                item->setThumbnailSize(QSize(size, size));
+            }
+
+            item->setModel(model);
+
+            return item;
+        });
+
+    registerItemType("dropdown", [](const QJsonObject& object)
+        {
+            auto* item = new OfficeMenuDropdownItem;
+            auto* model = new QStandardItemModel(item);
+
+            // Entries are either plain strings or objects with a "text" and
+            // an optional "value".
+            for (const auto& entryValue : object.value("entries").toArray())
+            {
+                const QJsonObject entry = entryValue.toObject();
+                auto* row = new QStandardItem(entryValue.isString()
+                    ? entryValue.toString()
+                    : entry.value("text").toString()
+                    );
+
+                if (entry.contains("value"))
+                    row->setData(entry.value("value").toVariant(), OfficeMenuDropdownItem::ValueRole);
+
+                model->appendRow(row);
+            }
+
+            item->setModel(model);
+            item->setCurrentIndex(object.value("current").toInt(-1));
+
+            return item;
+        });
+
+    registerItemType("fontpicker", [](const QJsonObject& object)
+        {
+            OfficeMenuFontPickerItem* item;
+            if (object.contains("families"))
+            {
+                QStringList families;
+                for (const auto& family : object.value("families").toArray())
+                {
+                    families.append(family.toString());
+                }
+
+                item = new OfficeMenuFontPickerItem(families);
+            }
+            else
+            {
+                item = new OfficeMenuFontPickerItem;
+            }
+
+            if (object.contains("current"))
+            {
+                item->setCurrentFont(QFont(object.value("current").toString()));
+            }
+
+            return item;
+        });
+}
+
+void OfficeMenuLoader::registerItemType(const QString& type, ItemFactory factory)
+{
+    m_factories.insert(type, std::move(factory));
+}
+
+bool OfficeMenuLoader::isLazy() const
+{
+    return m_isLazy;
+}
+
+void OfficeMenuLoader::setLazy(bool lazy)
+{
+    m_isLazy = lazy;
+}
+
+bool OfficeMenuLoader::load(OfficeMenu* menu, const QByteArray& data, Format format)
+{
+    OffTraceScope("OfficeMenuLoader::load");
+
+    QElapsedTimer timer;
+    QJsonObject root;
+
+    m_errorString.clear();
+    m_timings = Timings();
+
+    timer.start();
+    bool success = parse(data, format, root);
+    m_timings.parse = timer.nsecsElapsed();
+
+    if (success)
+    {
+        timer.restart();
+        success = validate(menu, root);
+        m_timings.validate = timer.nsecsElapsed();
+    }
+
+    if (success)
+    {
+        build(menu, root);
+    }
+
+    return success;
+}
+
+bool OfficeMenuLoader::loadFile(OfficeMenu* menu, const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        m_errorString = QString("%1: %2").arg(path, file.errorString());
+        return false;
+    }
+
+    Format format = path.endsWith(".cbor", Qt::CaseInsensitive) ? Cbor : Json;
+    return load(menu, file.readAll(), format);
+}
+
+const QString& OfficeMenuLoader::errorString() const
+{
+    return m_errorString;
+}
+
+const OfficeMenuLoader::Timings& OfficeMenuLoader::timings() const
+{
+    return m_timings;
+}
+
+bool OfficeMenuLoader::parse(const QByteArray& data, Format format, QJsonObject& root)
+{
+    if (format == Json)
+    {
+        QJsonParseError error;
+        QJsonDocument document = QJsonDocument::fromJson(data, &error);
+        if (error.error != QJsonParseError::NoError)
+        {
+            m_errorString = QString("offset %1: %2").arg(error.offset).arg(error.errorString());
+            return false;
+        }
+
+        root = document.object();
+        if (!document.isObject())
+        {
+            m_errorString = "the definition is not an object";
+            return false;
+        }
+
+        return true;
+    }
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+    QCborParserError error;
+    QCborValue value = QCborValue::fromCbor(data, &error);
+    if (error.error != QCborError::NoError)
+    {
+        m_errorString = QString("offset %1: %2").arg(error.offset).arg(error.errorString());
+        return false;
+    }
+
+    if (!value.isMap())
+    {
+        m_errorString = "the definition is not a map";
+        return false;
+    }
+
+    root = value.toMap().toJsonObject();
+    return true;
+#else
+    m_errorString = "CBOR definitions require Qt 5.12 or newer";
+    return false;
+#endif
+}
+
+bool OfficeMenuLoader::validate(const OfficeMenu* menu, const QJsonObject& root)
+{
+    OffTraceScope("OfficeMenuLoader::validate");
+
+    // Reports the first error along with the path to the offending object,
+    // e.g. "headers[2].panels[0].items[3]: unknown item type 'button'".
+    auto fail = [this](const QString& path, const QString& message)
+        {
+            m_errorString = QString("%1: %2").arg(path, message);
+            return false;
+        };
+
+    const QJsonValue headers = root.value("headers");
+    if (!headers.isArray())
+    {
+        return fail("headers", "expected an array");
+    }
+
+    QSet<int> headerIds;
+    const QJsonArray headerArray = headers.toArray();
+    for (int h = 0; h < headerArray.size(); h++)
+    {
+        const QString headerPath = QString("headers[%1]").arg(h);
+        const QJsonObject header = headerArray.at(h).toObject();
+        int headerId;
+
+        if (!headerArray.at(h).isObject())
+            return fail(headerPath, "expected an object");
+        if (!header.contains("id") || !readInt(header, "id", -1, &headerId))
+            return fail(headerPath, "expected an integral id");
+        if (headerIds.contains(headerId) || menu->headerById(headerId) != nullptr)
+            return fail(headerPath, QString("duplicate header id %1").arg(headerId));
+
+        headerIds.insert(headerId);
+
+        const QJsonValue panels = header.value("panels");
+        if (!panels.isUndefined() && !panels.isArray())
+        {
+            return fail(headerPath, "expected panels to be an array");
+        }
+
+        QSet<int> panelIds;
+        const QJsonArray panelArray = panels.toArray();
+        for (int p = 0; p < panelArray.size(); p++)
+        {
+            const QString panelPath = childPath(headerPath, "panels", p);
+            const QJsonObject panel = panelArray.at(p).toObject();
+            int panelId;
+
+            if (!panelArray.at(p).isObject())
+                return fail(panelPath, "expected an object");
+            if (!panel.contains("id") || !readInt(panel, "id", -1, &panelId))
+                return fail(panelPath, "expected an integral id");
+            if (panelIds.contains(panelId))
+                return fail(panelPath, QString("duplicate panel id %1").arg(panelId));
+
+            panelIds.insert(panelId);
+
+            const QJsonValue items = panel.value("items");
+            if (!items.isUndefined() && !items.isArray())
+            {
+                return fail(panelPath, "expected items to be an array");
+            }
+
+            QSet<int> itemIds;
+            const QJsonArray itemArray = items.toArray();
+            for (int i = 0; i < itemArray.size(); i++)
+            {
+                const QString itemPath = childPath(panelPath, "items", i);
+                const QJsonObject item = itemArray.at(i).toObject();
+                const QString type = item.value("type").toString();
+                int itemId, row, column, rowSpan, columnSpan;
+
+                if (!itemArray.at(i).isObject())
+                    return fail(itemPath, "expected an object");
+                if (!item.contains("id") || !readInt(item, "id", -1, &itemId))
+                    return fail(itemPath, "expected an integral id");
+                if (itemIds.contains(itemId))
+                    return fail(itemPath, QString("duplicate item id %1").arg(itemId));
+                if (!m_factories.contains(type))
+                    return fail(itemPath, QString("unknown item type '%1'").arg(type));
+                if (!readInt(item, "row", 0, &row) || row < 0 ||
+                    !readInt(item, "column", 0, &column) || column < 0)
+                    return fail(itemPath, "expected a non-negative row and column");
+                if (!readInt(item, "rowSpan", 1, &rowSpan) || rowSpan < 1 ||
+                    !readInt(item, "columnSpan", 1, &columnSpan) || columnSpan < 1)
+                    return fail(itemPath, "expected a positive row and column span");
+
+                itemIds.insert(itemId);
+            }
+        }
+    }
+
+    return true;
+}
+
+void OfficeMenuLoader::build(OfficeMenu* menu, const QJsonObject& root)
+{
+    OffTraceScope("OfficeMenuLoader::build");
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // Suspends all layouts while building, so that every inserted header and
+    // item does not lay out the menu again.
+    menu->beginUpdate();
+
+    for (const auto& headerValue : root.value("headers").toArray())
+    {
+        const QJsonObject headerObject = headerValue.toObject();
+        const int headerId = headerObject.value("id").toInt();
+
+        auto* header = menu->appendHeader(headerId, headerObject.value("text").toString());
+
+        for (const auto& panelValue : headerObject.value("panels").toArray())
+        {
+            const QJsonObject panelObject = panelValue.toObject();
+            const int panelId = panelObject.value("id").toInt();
+            const QString panelText = panelObject.value("text").toString();
+
+            OfficeMenuPanel* panel = nullptr;
+            if (m_isLazy)
+                header->declarePanel(panelId, panelText);
+            else
+                panel = header->appendPanel(panelId, panelText);
+
+            for (const auto& itemValue : panelObject.value("items").toArray())
+            {
+                const QJsonObject itemObject = itemValue.toObject();
+                const ItemFactory& factory = m_factories[itemObject.value("type").toString()];
+                const int itemId = itemObject.value("id").toInt();
+                int row, column, rowSpan, columnSpan;
+
+                readInt(itemObject, "row", 0, &row);
+                readInt(itemObject, "column", 0, &column);
+                readInt(itemObject, "rowSpan", 1, &rowSpan);
+                readInt(itemObject, "columnSpan", 1, &columnSpan);
+
+                auto create = [factory, itemObject]()
+                    {
+                        auto* item = factory(itemObject);
+                        if (item != nullptr && itemObject.contains("searchText"))
+                        {
+                            item->setSearchText(itemObject.value("searchText").toString());
+                        }
+
+                        return item;
+                    };
+
+                if (m_isLazy)
+                {
+                    header->declareItem(
+                        panelId, itemId,
+                        create,
+                        row, column,
+                        rowSpan, columnSpan
+                        );
+                }
+                else
+                {
+                    auto* item = create();
+                    if (item == nullptr ||
+                        !panel->insertItem(itemId, item, row, column, rowSpan, columnSpan))
+                    {
+                        delete item;
+                    }
+                }
+            }
+        }
+    }
+
+    m_timings.build = timer.nsecsElapsed();
+    timer.restart();
+
+    // Attaches the complete tree at once.
+    menu->endUpdate();
+
+    m_timings.attach = timer.nsecsElapsed();
+}
@@ -25,7 +25,9 @@
 #include <QOffice/Widgets/OfficeMenuItem.hpp>
 #include <QOffice/Widgets/OfficeMenuPanel.hpp>
 #include <QOffice/Widgets/OfficeMenuHeader.hpp>
+#include <QOffice/Widgets/OfficeMenuPanelBar.hpp>
 
+#include <QEvent>
 #include <QGridLayout>
 #include <QPainter>
 #include <QTextOption>
@@ -35,6 +37,7 @@ OfficeMenuPanel::OfficeMenuPanel(QWidget* panelBar, OfficeMenuHeader* header)
     , m_layout(new QGridLayout(this))
     , m_parent(header)
     , m_text("Panel")
+    , m_collapsePriority(0)
     , m_id(-1)
 {
     m_layout->setSpacing(4);
@@ -59,15 +62,14 @@ const QString& OfficeMenuPanel::text() const
     return m_text;
 }
 
-OfficeMenuItem* OfficeMenuPanel::itemById(int id) const
+int OfficeMenuPanel::collapsePriority() const
 {
-    for (auto* item : m_items)
-    {
-        if (item->id() == id)
-            return item;
-    }
+    return m_collapsePriority;
+}
 
-    return nullptr;
+OfficeMenuItem* OfficeMenuPanel::itemById(int id) const
+{
+    return m_itemIndex.value(id, nullptr);
 }
 
 OfficeMenuItem* OfficeMenuPanel::operator [](int id) const
@@ -75,14 +77,41 @@ OfficeMenuItem* OfficeMenuPanel::operator [](int id) const
     return itemById(id);
 }
 
-void OfficeMenuPanel::setId(int id)
+bool OfficeMenuPanel::setId(int id)
 {
+    // Re-keys the lookup table of the header if this panel is registered. The
+    // entry of another panel with the same ID is never overwritten.
+    if (m_parent != nullptr && m_parent->m_panelIndex.value(m_id) == this)
+    {
+        if (id != m_id && m_parent->m_panelIndex.contains(id))
+        {
+            return false;
+        }
+
+        m_parent->m_panelIndex.remove(m_id);
+        m_parent->m_panelIndex.insert(id, this);
+    }
+
     m_id = id;
+    return true;
 }
 
 void OfficeMenuPanel::setText(const QString& text)
 {
     m_text = text;
+    m_parent->menu()->m_searchIndex.update(this, text);
+
+    invalidateSizeHint();
+}
+
+void OfficeMenuPanel::setCollapsePriority(int priority)
+{
+    m_collapsePriority = priority;
+
+    if (m_parent->m_panelBar != nullptr)
+    {
+        m_parent->m_panelBar->invalidate();
+    }
 }
 
 bool OfficeMenuPanel::insertItem(
@@ -91,18 +120,19 @@ bool OfficeMenuPanel::insertItem(
     int rowSpan, int columnSpan
     )
 {
-    if (item->widget() == nullptr || itemById(id) != nullptr)
+    if (item->widget() == nullptr || m_itemIndex.contains(id))
     {
         return false;
     }
 
     item->setId(id);
     item->setPanel(this);
-    item->widget()->setProperty("qoffice_menu_item", true);
-    item->widget()->installEventFilter(header()->menu());
 
     m_items.append(item);
+    m_itemIndex.insert(id, item);
+    header()->menu()->indexItem(item);
     m_layout->addWidget(item->widget(), row, column, rowSpan, columnSpan);
+    invalidateSizeHint();
 
     return true;
 }
@@ -113,18 +143,51 @@ bool OfficeMenuPanel::removeItem(int id)
     if (item != nullptr)
     {
         m_items.removeOne(item);
+        m_itemIndex.remove(id);
+        header()->menu()->unindexItem(item);
 
         if (item->widget() != nullptr)
             m_layout->removeWidget(item->widget());
 
         delete item;
+        invalidateSizeHint();
     }
 
     return item != nullptr;
 }
 
+bool OfficeMenuPanel::reindexItem(OfficeMenuItem* item, int id)
+{
+    if (m_itemIndex.value(item->id()) == item)
+    {
+        // Item IDs are unique per panel, just like in insertItem.
+        if (m_itemIndex.contains(id))
+        {
+            return false;
+        }
+
+        OfficeMenu* menu = header()->menu();
+        menu->m_itemIndex.remove(item->id(), item);
+        menu->m_itemIndex.insert(id, item);
+
+        m_itemIndex.remove(item->id());
+        m_itemIndex.insert(id, item);
+    }
+
+    return true;
+}
+
 QSize OfficeMenuPanel::sizeHint() const
 {
+    // The hint is queried on every layout pass of the panel bar, but only
+    // changes along with the items, the text or the font.
+    if (m_sizeHint.isValid())
+    {
+        return m_sizeHint;
+    }
+
+    OffTraceScope("OfficeMenuPanel::layout");
+
     auto lhint = m_layout->sizeHint();
     auto width = fontMetrics().width(m_text);
 
@@ -133,17 +196,48 @@ QSize OfficeMenuPanel::sizeHint() const
         // If the text is bigger than the contents of the layout, the text
         // would be cut off due to the lack of space. This hack ensures that
         // the text is always fully visible, no matter what.
-        return QSize(width + 16, lhint.height());
+        m_sizeHint = QSize(width + 16, lhint.height());
     }
     else
     {
-        return lhint;
+        m_sizeHint = lhint;
+    }
+
+    return m_sizeHint;
+}
+
+bool OfficeMenuPanel::event(QEvent* event)
+{
+    switch (event->type())
+    {
+    case QEvent::LayoutRequest:
+    case QEvent::FontChange:
+    case QEvent::StyleChange:
+        invalidateSizeHint();
+        break;
+
+    default:
+        break;
     }
 
+    return QWidget::event(event);
+}
+
+void OfficeMenuPanel::invalidateSizeHint()
+{
+    m_sizeHint = QSize();
+    updateGeometry();
+
+    if (m_parent->m_panelBar != nullptr)
+    {
+        m_parent->m_panelBar->invalidate();
+    }
 }
 
 void OfficeMenuPanel::paintEvent(QPaintEvent*)
 {
+    OffTraceScope("OfficeMenuPanel::paint");
+
     QPainter painter(this);
 
     const QRect textRect = rect().adjusted(0,0,0,-4);
@@ -22,10 +22,134 @@
 
 #include <QOffice/Design/OfficePalette.hpp>
 #include <QOffice/Widgets/OfficeMenu.hpp>
+#include <QOffice/Widgets/OfficeMenuHeader.hpp>
+#include <QOffice/Widgets/OfficeMenuPanel.hpp>
 #include <QOffice/Widgets/OfficeMenuPanelBar.hpp>
+#include <QOffice/Widgets/OfficeMenuPinButton.hpp>
 
-priv::PanelBar::PanelBar(OfficeMenu* parent)
+#include <QBoxLayout>
+#include <QHash>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QResizeEvent>
+#include <QTimer>
+
+#include <algorithm>
+
+static QOFFICE_CONSTEXPR int c_buttonPadding = 16;
+static QOFFICE_CONSTEXPR int c_arrowSize = 4;
+
+priv::PanelButton::PanelButton(QWidget* parent, OfficeMenuPanel* panel)
+    : QWidget(parent)
+    , m_panel(panel)
+    , m_popup(new QWidget(this, Qt::Popup))
+    , m_isHovered(false)
+{
+    QHBoxLayout* layout = new QHBoxLayout(m_popup);
+    layout->setContentsMargins(1,1,1,1);
+
+    m_popup->setAutoFillBackground(true);
+    m_popup->setBackgroundRole(QPalette::Window);
+
+    setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Preferred);
+}
+
+int priv::PanelButton::widthFor(const QFontMetrics& metrics, const QString& text)
+{
+    return metrics.width(text) + c_buttonPadding;
+}
+
+void priv::PanelButton::attachPanel()
+{
+    m_popup->layout()->addWidget(m_panel);
+    m_panel->show();
+}
+
+void priv::PanelButton::detachPanel()
+{
+    m_popup->hide();
+    m_popup->layout()->removeWidget(m_panel);
+}
+
+QSize priv::PanelButton::sizeHint() const
+{
+    return QSize(widthFor(fontMetrics(), m_panel->text()), 0);
+}
+
+void priv::PanelButton::paintEvent(QPaintEvent*)
+{
+    OffTraceScope("PanelButton::paint");
+
+    QPainter painter(this);
+
+    const QRect textRect = rect().adjusted(0,0,0,-4);
+    const QPoint arrow = rect().center();
+    const QColor& colorForeground = OfficePalette::color(OfficePalette::Foreground);
+    const QColor& colorSeparator = OfficePalette::color(OfficePalette::MenuSeparator);
+
+    if (m_isHovered || m_popup->isVisible())
+    {
+        painter.fillRect(rect(), OfficePalette::color(OfficePalette::MenuItemHover));
+    }
+
+    // Text
+    painter.setPen(colorForeground);
+    painter.drawText(textRect, m_panel->text(), QTextOption(Qt::AlignHCenter | Qt::AlignBottom));
+
+    // Drop-down arrow
+    const QPoint points[] =
+    {
+        arrow + QPoint(-c_arrowSize, -c_arrowSize / 2),
+        arrow + QPoint(c_arrowSize, -c_arrowSize / 2),
+        arrow + QPoint(0, c_arrowSize / 2)
+    };
+
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setBrush(colorForeground);
+    painter.drawPolygon(points, 3);
+    painter.setRenderHint(QPainter::Antialiasing, false);
+
+    // Separator
+    painter.setPen(colorSeparator);
+    painter.drawLine(rect().topRight() + QPoint(0,4), rect().bottomRight() - QPoint(0,4));
+}
+
+void priv::PanelButton::enterEvent(QEvent* event)
+{
+    m_isHovered = true;
+    update();
+
+    QWidget::enterEvent(event);
+}
+
+void priv::PanelButton::leaveEvent(QEvent* event)
+{
+    m_isHovered = false;
+    update();
+
+    QWidget::leaveEvent(event);
+}
+
+void priv::PanelButton::mousePressEvent(QMouseEvent* event)
+{
+    if (event->button() == Qt::LeftButton)
+    {
+        // The popup is at least as high as the panel bar, which it replaces.
+        m_popup->adjustSize();
+        m_popup->move(mapToGlobal(rect().bottomLeft()));
+        m_popup->show();
+        update();
+    }
+
+    QWidget::mousePressEvent(event);
+}
+
+priv::PanelBar::PanelBar(OfficeMenu* parent, OfficeMenuHeader* header)
     : QWidget(parent)
+    , m_header(header)
+    , m_reservedWidth(0)
+    , m_isDirty(true)
+    , m_isScheduled(false)
 {
     QString css = Office::loadStyleSheet("OfficeMenuPanelBar");
     QString color1 = Office::colorToHex(
@@ -40,13 +164,205 @@ priv::PanelBar::PanelBar(OfficeMenu* parent)
     setSizePolicy(QSizePolicy::Ignored, QSizePolicy::Preferred);
     setStyleSheet(css.arg(color1, color2));
 
-    // Hack: Treat panel bar as menu, for the focus-out events.
     setFocusPolicy(Qt::ClickFocus);
-    setProperty("qoffice_menu", true);
-    installEventFilter(parent);
+}
+
+void priv::PanelBar::invalidate()
+{
+    m_isDirty = true;
+
+    // Panels invalidate their size hint once per change, which easily happens
+    // a hundred times while a panel is filled; adapts only once afterwards.
+    // Hidden panel bars adapt once they are resized or expanded.
+    if (!m_isScheduled && isVisible())
+    {
+        m_isScheduled = true;
+        QTimer::singleShot(0, this, [this]()
+            {
+                m_isScheduled = false;
+                adapt();
+            });
+    }
+}
+
+void priv::PanelBar::adapt()
+{
+    OffTraceScope("PanelBar::adapt");
+
+    // Resize events may still arrive while the header is being destroyed.
+    if (m_header == nullptr)
+    {
+        return;
+    }
+
+    if (m_isDirty)
+    {
+        measure();
+    }
+
+    const int spacing = m_header->m_panelLayout->spacing();
+    const int available = width() - m_reservedWidth;
+    int required = 0;
+
+    for (const auto& state : m_states)
+    {
+        required += state.fullWidth + spacing;
+    }
+
+    // Collapses panels in priority order until the remaining ones fit.
+    QVector<bool> collapse(m_states.size(), false);
+    for (int index : m_order)
+    {
+        if (required <= available)
+            break;
+
+        const PanelState& state = m_states.at(index);
+        if (state.reducedWidth < state.fullWidth)
+        {
+            required -= state.fullWidth - state.reducedWidth;
+            collapse[index] = true;
+        }
+    }
+
+    for (int i = 0; i < m_states.size(); i++)
+    {
+        if (m_states.at(i).isCollapsed != collapse.at(i))
+        {
+            setCollapsed(m_states[i], collapse.at(i));
+        }
+    }
+}
+
+void priv::PanelBar::release(OfficeMenuPanel* panel)
+{
+    if (m_header == nullptr)
+    {
+        return;
+    }
+
+    for (int i = 0; i < m_states.size(); i++)
+    {
+        if (m_states.at(i).panel == panel)
+        {
+            if (m_states.at(i).isCollapsed)
+            {
+                setCollapsed(m_states[i], false);
+            }
+
+            delete m_states.at(i).button;
+            m_states.remove(i);
+            break;
+        }
+    }
+
+    invalidate();
 }
 
 QSize priv::PanelBar::sizeHint() const
 {
     return QSize(parentWidget()->width(), 90);
 }
+
+void priv::PanelBar::resizeEvent(QResizeEvent* event)
+{
+    if (event->size().width() != event->oldSize().width())
+    {
+        adapt();
+    }
+
+    QWidget::resizeEvent(event);
+}
+
+void priv::PanelBar::measure()
+{
+    OffTraceScope("PanelBar::measure");
+
+    // Keeps the buttons and states of panels that were measured before.
+    QHash<OfficeMenuPanel*, PanelState> previous;
+    for (const auto& state : m_states)
+    {
+        previous.insert(state.panel, state);
+    }
+
+    const QFontMetrics metrics = fontMetrics();
+    m_states.clear();
+    m_order.clear();
+
+    for (auto* panel : m_header->m_panels)
+    {
+        PanelState state = previous.value(panel, { panel, nullptr, 0, 0, false });
+        state.fullWidth = panel->sizeHint().width();
+        state.reducedWidth = PanelButton::widthFor(metrics, panel->text());
+
+        m_order.append(m_states.size());
+        m_states.append(state);
+    }
+
+    // Panels of equal priority collapse from right to left.
+    std::stable_sort(m_order.begin(), m_order.end(), [this](int a, int b)
+        {
+            const int pa = m_states.at(a).panel->collapsePriority();
+            const int pb = m_states.at(b).panel->collapsePriority();
+
+            return pa != pb ? pa < pb : a > b;
+        });
+
+    // The pin button always stays visible at the bottom right.
+    const PinButton* pin = findChild<PinButton*>();
+    m_reservedWidth = layout() != nullptr ? layout()->spacing() * 2 : 0;
+    if (pin != nullptr)
+    {
+        m_reservedWidth += pin->sizeHint().width();
+    }
+
+    m_isDirty = false;
+}
+
+void priv::PanelBar::setCollapsed(PanelState& state, bool collapsed)
+{
+    QHBoxLayout* layout = m_header->m_panelLayout;
+
+    if (collapsed)
+    {
+        if (state.button == nullptr)
+        {
+            state.button = new PanelButton(this, state.panel);
+        }
+
+        delete layout->replaceWidget(state.panel, state.button);
+        state.button->attachPanel();
+        state.button->show();
+    }
+    else
+    {
+        state.button->detachPanel();
+        delete layout->replaceWidget(state.button, state.panel);
+        state.button->hide();
+        state.panel->show();
+    }
+
+    state.isCollapsed = collapsed;
+}
+
+priv::PanelBarSnapshot::PanelBarSnapshot(OfficeMenu* parent)
+    : QWidget(parent)
+{
+    // The pixmap covers the widget entirely; nothing behind it needs painting.
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+    hide();
+}
+
+void priv::PanelBarSnapshot::setPixmap(const QPixmap& pixmap)
+{
+    m_pixmap = pixmap;
+    update();
+}
+
+void priv::PanelBarSnapshot::paintEvent(QPaintEvent*)
+{
+    OffTraceScope("PanelBarSnapshot::paint");
+
+    QPainter painter(this);
+    painter.drawPixmap(0, 0, m_pixmap);
+}
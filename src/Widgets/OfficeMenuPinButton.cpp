@@ -24,7 +24,7 @@
 #include <QOffice/Widgets/OfficeMenu.hpp>
 #include <QOffice/Widgets/OfficeMenuHeader.hpp>
 #include <QOffice/Widgets/OfficeMenuPinButton.hpp>
-#include <QOffice/Widgets/OfficeTooltip.hpp>
+#include <QOffice/Widgets/OfficeTooltipManager.hpp>
 
 #include <QPainter>
 #include <QMouseEvent>
@@ -34,7 +34,6 @@ static bool g_isSticky = false;
 priv::PinButton::PinButton(OfficeMenuHeader* parent)
     : QWidget(parent)
     , m_parent(parent)
-    , m_tooltip(new OfficeTooltip)
     , m_imgSticky(":/qoffice/images/widgets/menu_sticky.png")
     , m_imgCollapse(":/qoffice/images/widgets/menu_collapse.png")
     , m_isHovered(false)
@@ -45,13 +44,12 @@ priv::PinButton::PinButton(OfficeMenuHeader* parent)
     setMaximumSize(30, 16);
     setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
 
-    m_tooltip->setWaitPeriod(1000);
-    m_tooltip->setHelpEnabled(false);
+    OfficeTooltipManager::instance()->acquire();
 }
 
 priv::PinButton::~PinButton()
 {
-    delete m_tooltip;
+    OfficeTooltipManager::instance()->release();
 }
 
 QSize priv::PinButton::sizeHint() const
@@ -61,6 +59,8 @@ QSize priv::PinButton::sizeHint() const
 
 void priv::PinButton::paintEvent(QPaintEvent*)
 {
+    OffTraceScope("PinButton::paint");
+
     QPainter painter(this);
 
     if (m_isPressed)
@@ -84,25 +84,24 @@ void priv::PinButton::paintEvent(QPaintEvent*)
 
 void priv::PinButton::enterEvent(QEvent* event)
 {
-    m_tooltip->hide();
-    m_tooltip->move(QCursor::pos());
-    m_tooltip->resize(200, 100);
+    OfficeTooltipContent content;
+    content.waitPeriod = 1000;
 
     if (!g_isSticky)
     {
-        m_tooltip->setTitle("Pin");
-        m_tooltip->setText("Pins the ribbon bar and makes it permanent.");
+        content.title = "Pin";
+        content.text = "Pins the ribbon bar and makes it permanent.";
     }
     else
     {
-        m_tooltip->setTitle("Collapse");
-        m_tooltip->setText("Unpins the ribbon bar and makes it temporary.");
+        content.title = "Collapse";
+        content.text = "Unpins the ribbon bar and makes it temporary.";
     }
 
     // Hack: Showing the tooltip would steal the focus of the OfficeMenu,
     // causing it to collapse. We temporarily "pin" the menu for that purpose.
     m_parent->menu()->m_isTooltipShown = true;
-    m_tooltip->show();
+    OfficeTooltipManager::instance()->show(this, content, QRect(QCursor::pos(), QSize(200, 100)));
     m_isHovered = true;
 
     update();
@@ -113,7 +112,7 @@ void priv::PinButton::enterEvent(QEvent* event)
 void priv::PinButton::leaveEvent(QEvent* event)
 {
     m_parent->menu()->m_isTooltipShown = false;
-    m_tooltip->hide();
+    OfficeTooltipManager::instance()->hide(this);
     m_isHovered = false;
 
     update();
@@ -140,7 +139,7 @@ void priv::PinButton::mouseReleaseEvent(QMouseEvent* event)
         m_parent->menu()->setPinned(g_isSticky);
     }
 
-    m_tooltip->hide();
+    OfficeTooltipManager::instance()->hide(this);
     m_isPressed = false;
     update();
 
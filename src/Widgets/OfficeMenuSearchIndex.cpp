@@ -0,0 +1,289 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// QOffice - The office framework for Qt
+// Copyright (C) 2016-2018 Nicolas Kogler
+//
+// This file is part of the Widget module.
+//
+// QOffice is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// QOffice is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with QOffice. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QOffice/Widgets/OfficeMenuSearchIndex.hpp>
+
+#include <algorithm>
+
+static QOFFICE_CONSTEXPR int c_prefixScore = 4000;
+static QOFFICE_CONSTEXPR int c_wordScore = 3000;
+static QOFFICE_CONSTEXPR int c_substringScore = 2000;
+static QOFFICE_CONSTEXPR int c_subsequenceScore = 1000;
+static QOFFICE_CONSTEXPR int c_maxPenalty = 999;
+
+static bool isWordStart(const QString& text, int pos)
+{
+    return pos == 0 ||
+        !text.at(pos - 1).isLetterOrNumber() ||
+        (text.at(pos).isUpper() && text.at(pos - 1).isLower());
+}
+
+OfficeMenuSearchIndex::OfficeMenuSearchIndex()
+{
+}
+
+int OfficeMenuSearchIndex::size() const
+{
+    return m_slots.size();
+}
+
+void OfficeMenuSearchIndex::insert(
+    const QString& text,
+    OfficeMenuHeader* header,
+    OfficeMenuPanel* panel,
+    OfficeMenuItem* item
+    )
+{
+    const void* owner = item != nullptr
+        ? static_cast<const void*>(item)
+        : panel != nullptr
+            ? static_cast<const void*>(panel)
+            : static_cast<const void*>(header);
+
+    remove(owner);
+
+    Entry entry;
+    entry.match = { header, panel, item, text, 0 };
+    entry.folded = fold(text);
+    entry.mask = maskOf(entry.folded);
+    entry.isAlive = true;
+
+    // Reuses the slots of removed entries, so that the entries stay packed.
+    int slot;
+    if (!m_free.isEmpty())
+    {
+        slot = m_free.takeLast();
+        m_entries[slot] = entry;
+    }
+    else
+    {
+        slot = m_entries.size();
+        m_entries.append(entry);
+    }
+
+    m_slots.insert(owner, slot);
+    invalidate();
+}
+
+bool OfficeMenuSearchIndex::update(const void* owner, const QString& text)
+{
+    auto it = m_slots.constFind(owner);
+    if (it == m_slots.constEnd())
+    {
+        return false;
+    }
+
+    Entry& entry = m_entries[it.value()];
+    entry.match.text = text;
+    entry.folded = fold(text);
+    entry.mask = maskOf(entry.folded);
+
+    invalidate();
+
+    return true;
+}
+
+bool OfficeMenuSearchIndex::remove(const void* owner)
+{
+    auto it = m_slots.find(owner);
+    if (it == m_slots.end())
+    {
+        return false;
+    }
+
+    Entry& entry = m_entries[it.value()];
+    entry.isAlive = false;
+    entry.match.text.clear();
+    entry.folded.clear();
+
+    m_free.append(it.value());
+    m_slots.erase(it);
+    invalidate();
+
+    return true;
+}
+
+void OfficeMenuSearchIndex::clear()
+{
+    m_entries.clear();
+    m_free.clear();
+    m_slots.clear();
+    invalidate();
+}
+
+QVector<OfficeMenuSearchIndex::Match> OfficeMenuSearchIndex::search(const QString& query, int limit)
+{
+    OffTraceScope("OfficeMenuSearchIndex::search");
+
+    QVector<Match> matches;
+    const QString folded = fold(query.trimmed());
+    if (folded.isEmpty() || limit <= 0)
+    {
+        return matches;
+    }
+
+    struct Candidate
+    {
+        int slot;
+        int score;
+    };
+
+    const quint64 mask = maskOf(folded);
+    QVector<Candidate> candidates;
+    QVector<int> slots;
+
+    auto examine = [&](int slot)
+        {
+            // The mask rejects most entries without looking at their text.
+            const Entry& entry = m_entries.at(slot);
+            if (!entry.isAlive || (entry.mask & mask) != mask)
+            {
+                return;
+            }
+
+            const int value = score(entry, folded);
+            if (value >= 0)
+            {
+                candidates.append({ slot, value });
+                slots.append(slot);
+            }
+        };
+
+    // Every kind of match is a subsequence match. A text that does not match
+    // the previous query therefore cannot match a query that extends it.
+    if (!m_lastQuery.isEmpty() && folded.startsWith(m_lastQuery))
+    {
+        for (int slot : m_lastCandidates)
+            examine(slot);
+    }
+    else
+    {
+        for (int slot = 0; slot < m_entries.size(); slot++)
+            examine(slot);
+    }
+
+    m_lastQuery = folded;
+    m_lastCandidates.swap(slots);
+
+    // Only the requested amount of matches needs to be ordered.
+    const int count = qMin(limit, candidates.size());
+    std::partial_sort(
+        candidates.begin(),
+        candidates.begin() + count,
+        candidates.end(),
+        [](const Candidate& a, const Candidate& b)
+            {
+                return a.score != b.score ? a.score > b.score : a.slot < b.slot;
+            });
+
+    matches.reserve(count);
+    for (int i = 0; i < count; i++)
+    {
+        Match match = m_entries.at(candidates.at(i).slot).match;
+        match.score = candidates.at(i).score;
+        matches.append(match);
+    }
+
+    return matches;
+}
+
+void OfficeMenuSearchIndex::invalidate()
+{
+    m_lastQuery.clear();
+    m_lastCandidates.clear();
+}
+
+QString OfficeMenuSearchIndex::fold(const QString& text)
+{
+    // Folds every character on its own, so that positions in the folded text
+    // equal positions in the original text.
+    QString folded(text);
+    for (QChar& c : folded)
+    {
+        c = c.toCaseFolded();
+    }
+
+    return folded;
+}
+
+quint64 OfficeMenuSearchIndex::maskOf(const QString& folded)
+{
+    quint64 mask = 0;
+    for (QChar c : folded)
+    {
+        const ushort u = c.unicode();
+        if (u >= 'a' && u <= 'z')
+            mask |= Q_UINT64_C(1) << (u - 'a');
+        else if (u >= '0' && u <= '9')
+            mask |= Q_UINT64_C(1) << (26 + u - '0');
+        else
+            mask |= Q_UINT64_C(1) << (36 + u % 28);
+    }
+
+    return mask;
+}
+
+int OfficeMenuSearchIndex::score(const Entry& entry, const QString& query)
+{
+    const QString& text = entry.folded;
+    const QString& original = entry.match.text;
+
+    if (text.startsWith(query))
+    {
+        return c_prefixScore - qMin(text.size(), c_maxPenalty);
+    }
+
+    int first = text.indexOf(query);
+    if (first != -1)
+    {
+        // Prefers occurrences at the start of a word, e.g. "pic" in "Insert
+        // Picture" over "pic" in "Topic".
+        for (int pos = first; pos != -1; pos = text.indexOf(query, pos + 1))
+        {
+            if (isWordStart(original, pos))
+                return c_wordScore - qMin(pos, c_maxPenalty);
+        }
+
+        return c_substringScore - qMin(first, c_maxPenalty);
+    }
+
+    // Matches the characters in order, as early as possible. Characters that
+    // start a word are rewarded, gaps between characters are penalized.
+    int pos = -1, penalty = 0;
+    for (QChar c : query)
+    {
+        const int next = text.indexOf(c, pos + 1);
+        if (next == -1)
+        {
+            return -1;
+        }
+
+        if (isWordStart(original, next))
+            penalty -= 4;
+        else if (pos != -1 && next != pos + 1)
+            penalty += next - pos;
+
+        pos = next;
+    }
+
+    return c_subsequenceScore - qBound(-c_maxPenalty, penalty, c_maxPenalty);
+}
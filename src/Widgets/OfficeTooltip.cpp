@@ -26,11 +26,17 @@
 #include <QOffice/Widgets/Dialogs/OfficeWindow.hpp>
 
 #include <QApplication>
+#include <QCache>
 #include <QDesktopWidget>
+#include <QFontDatabase>
 #include <QKeyEvent>
 #include <QMouseEvent>
 #include <QPainter>
+#include <QRunnable>
 #include <QScreen>
+#include <QThreadPool>
+
+#include <atomic>
 
 static QOFFICE_CONSTEXPR int c_margin  = c_shadowPadding + 10;
 static QOFFICE_CONSTEXPR int c_padding = c_margin * 2;
@@ -39,6 +45,315 @@ static QOFFICE_CONSTEXPR int c_iconMargin = 8;
 static QOFFICE_CONSTEXPR int c_helpMargin = 7;
 static QOFFICE_CONSTEXPR int c_separator  = 9;
 
+// Bounds the memory of cached layouts, in kilobytes of drop shadow pixels.
+static QOFFICE_CONSTEXPR int c_layoutCacheCost = 8192;
+
+struct TooltipLayoutKey
+{
+    QString title;
+    QString body;
+    QString help;
+    QString font;
+    qint64  icon;
+    int     width;
+    qreal   ratio;
+
+    bool operator ==(const TooltipLayoutKey& other) const
+    {
+        return width == other.width &&
+               ratio == other.ratio &&
+               icon  == other.icon  &&
+               title == other.title &&
+               body  == other.body  &&
+               help  == other.help  &&
+               font  == other.font;
+    }
+};
+
+static uint qHash(const TooltipLayoutKey& key, uint seed = 0)
+{
+    uint hash = qHash(key.title, seed);
+
+    hash ^= qHash(key.body, seed) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= qHash(key.help, seed) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= qHash(key.font, seed) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= qHash(key.icon, seed) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= qHash(key.width, seed) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= qHash(key.ratio, seed) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+
+    return hash;
+}
+
+static bool supportsWindowOpacity()
+{
+    // Only these platform plugins are known to fade translucent top-level
+    // windows in the window system; everywhere else, setWindowOpacity is a
+    // no-op or forces a software fallback.
+    const QString platform = QGuiApplication::platformName();
+
+    return platform == "windows" || platform == "cocoa";
+}
+
+// Tooltips of menu items are shown over and over again with the very same
+// contents; their geometry and drop shadow only need to be computed once.
+static QCache<TooltipLayoutKey, priv::TooltipLayout> g_layoutCache(c_layoutCacheCost);
+
+static TooltipLayoutKey layoutKey(const OfficeTooltip& tooltip)
+{
+    const TooltipLayoutKey key =
+    {
+        tooltip.title(),
+        tooltip.text(),
+        tooltip.helpText(),
+        tooltip.font().key(),
+        tooltip.helpIcon().cacheKey(),
+        tooltip.width(),
+        tooltip.devicePixelRatioF()
+    };
+
+    return key;
+}
+
+static void cacheLayout(const TooltipLayoutKey& key, const priv::TooltipLayout& layout)
+{
+    // The cost is the size of the shadow in kilobytes, which by far outweighs
+    // the rectangles.
+    const int cost = layout.dropShadow.width() * layout.dropShadow.height() * 4 / 1024;
+    g_layoutCache.insert(key, new priv::TooltipLayout(layout), qMax(cost, 1));
+}
+
+// Only uses its arguments, QFontMetrics and QImage; it is therefore safe to
+// call from any thread as long as threaded font rendering is supported.
+static priv::TooltipLayout computeLayout(
+    const TooltipLayoutKey& key,
+    const QFont& font,
+    const QSize& iconSize
+    )
+{
+    priv::TooltipLayout layout;
+
+    QFont normFont = font; normFont.setBold(false);
+    QFont boldFont = font; boldFont.setBold(true);
+
+    QFontMetrics normMetrics(normFont);
+    QFontMetrics boldMetrics(boldFont);
+
+    int currentX = c_margin;
+    int currentY = c_margin;
+
+    // Title
+    if (!key.title.isEmpty())
+    {
+        QRect bounds = boldMetrics.boundingRect(key.title);
+
+        layout.heading.setX(currentX);
+        layout.heading.setY(currentY);
+        layout.heading.setSize(bounds.size() + QSize(5, 5));
+
+        currentY += (bounds.height() + c_bodyMargin);
+    }
+
+    // Body
+    if (!key.body.isEmpty())
+    {
+        QRect max(0, 0, key.width - c_padding, 300);
+        QRect bounds = normMetrics.boundingRect(max, Qt::TextWordWrap, key.body);
+
+        layout.body.setX(currentX);
+        layout.body.setY(currentY);
+        layout.body.setSize(bounds.size());
+
+        currentY += bounds.height();
+    }
+
+    // Help
+    if (!key.help.isEmpty())
+    {
+        currentY += c_separator;
+
+        // Separator
+        layout.separator.setX(currentX);
+        layout.separator.setY(currentY);
+        layout.separator.setSize(QSize(key.width - c_padding, 1));
+
+        currentY += c_separator;
+
+        // Icon
+        layout.icon.setX(currentX);
+        layout.icon.setY(currentY);
+        layout.icon.setSize(iconSize);
+
+        currentX += (iconSize.width() + c_iconMargin);
+
+        // Text
+        layout.help.setX(currentX);
+        layout.help.setY(currentY);
+        layout.help.setWidth(boldMetrics.width(key.help));
+        layout.help.setHeight(boldMetrics.height());
+
+        currentY += layout.help.height();
+    }
+
+    layout.height = currentY + c_margin;
+    layout.dropShadow = OfficeImage::generateDropShadowImage(QSize(key.width, layout.height));
+
+    // Client
+    layout.client.setRect(
+        c_shadowPadding,
+        c_shadowPadding,
+        key.width     - c_shadowPadding * 2,
+        layout.height - c_shadowPadding * 2
+        );
+
+    // Border
+    layout.border = layout.client.adjusted(0,0,-1,-1);
+
+    return layout;
+}
+
+static void paintTooltip(
+    QPainter& painter,
+    const priv::TooltipLayout& layout,
+    const TooltipLayoutKey& key,
+    const QFont& font,
+    const QImage& icon,
+    bool helpEnabled,
+    bool linkHovered
+    )
+{
+    // Retrieves a standardized set of colors for this tooltip.
+    const QColor& colorBorder = OfficePalette::color(OfficePalette::TooltipBorder);
+    const QColor& colorBackg = OfficePalette::color(OfficePalette::TooltipBackground);
+    const QColor& colorText1 = OfficePalette::color(OfficePalette::TooltipText);
+    const QColor& colorText2 = OfficePalette::color(OfficePalette::TooltipHelpText);
+    const QColor& colorSeparator = OfficePalette::color(OfficePalette::TooltipSeparator);
+
+    // Drop-shadow
+    painter.drawImage(QPoint(), layout.dropShadow);
+
+    // Background and border
+    painter.setPen(colorBorder);
+    painter.fillRect(layout.client, colorBackg);
+    painter.drawRect(layout.border);
+
+    // Title
+    if (!key.title.isEmpty())
+    {
+        QFont currentFont = font;
+        currentFont.setBold(true);
+
+        painter.setFont(currentFont);
+        painter.setPen(colorText1);
+        painter.drawText(layout.heading, key.title);
+    }
+
+    // Body
+    if (!key.body.isEmpty())
+    {
+        painter.setFont(font);
+        painter.setPen(colorText1);
+        painter.drawText(layout.body, Qt::TextWordWrap, key.body);
+    }
+
+    // Help
+    if (helpEnabled && !key.help.isEmpty())
+    {
+        QFont currentFont = font;
+        currentFont.setBold(true);
+
+        painter.setFont(currentFont);
+        painter.setPen(colorText2);
+
+        painter.fillRect(layout.separator, colorSeparator);
+        painter.drawImage(layout.icon, icon);
+        painter.drawText(layout.help, key.help);
+
+        if (linkHovered)
+        {
+            QPoint p1(layout.help.left(),  layout.help.bottom());
+            QPoint p2(layout.help.right(), layout.help.bottom());
+
+            painter.drawLine(p1, p2);
+        }
+    }
+}
+
+namespace priv
+{
+struct TooltipJob
+{
+    TooltipJob()
+        : helpEnabled(false)
+        , cancelled(false)
+        , finished(false)
+    {
+    }
+
+    TooltipLayoutKey  key;
+    QFont             font;
+    QImage            icon;
+    bool              helpEnabled;
+    TooltipLayout     layout;
+    QImage            layer;
+    std::atomic<bool> cancelled;
+    std::atomic<bool> finished;
+};
+
+class TooltipRunnable : public QRunnable
+{
+public:
+
+    TooltipRunnable(const std::shared_ptr<TooltipJob>& job)
+        : m_job(job)
+    {
+    }
+
+    void run() override;
+
+private:
+
+    std::shared_ptr<TooltipJob> m_job;
+};
+}
+
+static void prepareTooltip(priv::TooltipJob& job)
+{
+    OffTraceScope("OfficeTooltip::prepare");
+
+    // The tooltip might have been hidden already; checked between the steps
+    // since the shadow and the text are the expensive parts.
+    if (job.cancelled.load())
+    {
+        return;
+    }
+
+    job.layout = computeLayout(job.key, job.font, job.icon.size());
+
+    if (job.cancelled.load())
+    {
+        return;
+    }
+
+    const QSize size(job.key.width, job.layout.height);
+
+    job.layer = QImage(size * job.key.ratio, QImage::Format_ARGB32_Premultiplied);
+    job.layer.setDevicePixelRatio(job.key.ratio);
+    job.layer.fill(Qt::transparent);
+
+    if (!job.layer.isNull())
+    {
+        QPainter painter(&job.layer);
+        paintTooltip(painter, job.layout, job.key, job.font, job.icon, job.helpEnabled, false);
+    }
+
+    job.finished.store(true, std::memory_order_release);
+}
+
+void priv::TooltipRunnable::run()
+{
+    prepareTooltip(*m_job);
+}
+
 OfficeTooltip::OfficeTooltip()
     : QWidget(nullptr)
     , m_timer(new QTimer(this))
@@ -52,10 +367,15 @@ OfficeTooltip::OfficeTooltip()
     , m_helpIcon(":/qoffice/images/widgets/tooltip_help.png")
     , m_duration(4000)
     , m_helpKey(Qt::Key_F1)
+    , m_fadeMode(LayerFade)
     , m_opacity(0.0)
     , m_isHelpEnabled(false)
     , m_isLinkHovered(false)
+    , m_isLayerDirty(true)
+    , m_useWindowOpacity(supportsWindowOpacity())
 {
+    m_helpImage = m_helpIcon.toImage();
+
     m_timer->setSingleShot(true);
     m_waitTimer->setSingleShot(true);
 
@@ -74,21 +394,6 @@ OfficeTooltip::OfficeTooltip()
     m_hideAnimation->setStartValue(1.0);
     m_hideAnimation->setEndValue(0.0);
 
-    // Need to use old syntax since update() has overloads :(
-    QObject::connect(
-        m_showAnimation,
-        SIGNAL(valueChanged(QVariant)),
-        this,
-        SLOT(update())
-        );
-
-    QObject::connect(
-        m_hideAnimation,
-        SIGNAL(valueChanged(QVariant)),
-        this,
-        SLOT(update())
-        );
-
     QObject::connect(
         m_timer,
         &QTimer::timeout,
@@ -151,6 +456,11 @@ int OfficeTooltip::waitPeriod() const
     return m_waitPeriod;
 }
 
+OfficeTooltip::FadeMode OfficeTooltip::fadeMode() const
+{
+    return m_fadeMode;
+}
+
 void OfficeTooltip::setTitle(const QString& title)
 {
     m_heading = title;
@@ -173,7 +483,12 @@ void OfficeTooltip::setHelpText(const QString& text)
 
 void OfficeTooltip::setHelpIcon(const QPixmap& icon)
 {
-    m_helpIcon = icon;
+    if (icon.cacheKey() != m_helpIcon.cacheKey())
+    {
+        // Painting may happen off the GUI thread, where pixmaps are unusable.
+        m_helpIcon = icon;
+        m_helpImage = icon.toImage();
+    }
 }
 
 void OfficeTooltip::setHelpKey(Qt::Key trigger)
@@ -191,66 +506,66 @@ void OfficeTooltip::setWaitPeriod(int milliseconds)
     m_waitPeriod = milliseconds;
 }
 
-void OfficeTooltip::paintEvent(QPaintEvent*)
+void OfficeTooltip::setFadeMode(FadeMode mode)
 {
-    QPainter painter(this);
+    m_fadeMode = mode;
+    m_isLayerDirty = true;
 
-    // Retrieves a standardized set of colors for this tooltip.
-    const QColor& colorBorder = OfficePalette::color(OfficePalette::TooltipBorder);
-    const QColor& colorBackg = OfficePalette::color(OfficePalette::TooltipBackground);
-    const QColor& colorText1 = OfficePalette::color(OfficePalette::TooltipText);
-    const QColor& colorText2 = OfficePalette::color(OfficePalette::TooltipHelpText);
-    const QColor& colorSeparator = OfficePalette::color(OfficePalette::TooltipSeparator);
+    if (m_useWindowOpacity)
+    {
+        setWindowOpacity(1.0);
+    }
+}
 
-    // Drop-shadow
-    painter.setOpacity(m_opacity);
-    painter.drawPixmap(QPoint(), m_dropShadow);
+void OfficeTooltip::paintEvent(QPaintEvent*)
+{
+    OffTraceScope("OfficeTooltip::paint");
 
-    // Background and border
-    painter.setPen(colorBorder);
-    painter.fillRect(m_clientRectangle, colorBackg);
-    painter.drawRect(m_borderRectangle);
+    // During the wait period the window is shown fully transparent and its
+    // contents are still being prepared by the job; painting them now would
+    // render the stale layout on the GUI thread for nothing. The layer is
+    // taken from the job once the tooltip fades in.
+    if (m_opacity == 0.0 || m_job)
+    {
+        return;
+    }
 
-    // Title
-    if (!m_heading.isEmpty())
+    QPainter painter(this);
+
+    if (m_fadeMode == PaintFade)
     {
-        QFont currentFont = font();
-        currentFont.setBold(true);
+        painter.setOpacity(m_opacity);
+        paintContent(painter);
 
-        painter.setFont(currentFont);
-        painter.setPen(colorText1);
-        painter.drawText(m_headingRectangle, m_heading);
+        return;
     }
 
-    // Body
-    if (!m_bodyText.isEmpty())
+    if (m_isLayerDirty)
     {
-        painter.setFont(font());
-        painter.setPen(colorText1);
-        painter.drawText(m_bodyRectangle, Qt::TextWordWrap, m_bodyText);
+        renderLayer();
     }
 
-    // Help
-    if (m_isHelpEnabled && !m_helpText.isEmpty())
+    // With window opacity, the window system fades the window and the
+    // contents are always painted opaque.
+    if (!m_useWindowOpacity)
     {
-        QFont currentFont = font();
-        currentFont.setBold(true);
-
-        painter.setFont(currentFont);
-        painter.setPen(colorText2);
-
-        painter.fillRect(m_sepaRectangle, colorSeparator);
-        painter.drawPixmap(m_iconRectangle, m_helpIcon);
-        painter.drawText(m_helpRectangle, m_helpText);
+        painter.setOpacity(m_opacity);
+    }
 
-        if (m_isLinkHovered)
-        {
-            QPoint p1(m_helpRectangle.left(),  m_helpRectangle.bottom());
-            QPoint p2(m_helpRectangle.right(), m_helpRectangle.bottom());
+    painter.drawPixmap(QPoint(), m_contentLayer);
+}
 
-            painter.drawLine(p1, p2);
-        }
-    }
+void OfficeTooltip::paintContent(QPainter& painter)
+{
+    paintTooltip(
+        painter,
+        m_layout,
+        layoutKey(*this),
+        font(),
+        m_helpImage,
+        m_isHelpEnabled,
+        m_isLinkHovered
+        );
 }
 
 void OfficeTooltip::mouseMoveEvent(QMouseEvent* event)
@@ -259,7 +574,7 @@ void OfficeTooltip::mouseMoveEvent(QMouseEvent* event)
     {
         bool previousState = m_isLinkHovered;
 
-        if (m_helpRectangle.contains(event->pos()))
+        if (m_layout.help.contains(event->pos()))
         {
             m_isLinkHovered = true;
             setCursor(Qt::PointingHandCursor);
@@ -272,6 +587,7 @@ void OfficeTooltip::mouseMoveEvent(QMouseEvent* event)
 
         if (m_isLinkHovered != previousState)
         {
+            m_isLayerDirty = true;
             update();
         }
     }
@@ -311,6 +627,12 @@ void OfficeTooltip::keyPressEvent(QKeyEvent* event)
 
 void OfficeTooltip::showEvent(QShowEvent*)
 {
+    if (m_fadeMode == LayerFade && m_useWindowOpacity)
+    {
+        // The window is shown during the wait period; keep it invisible.
+        setWindowOpacity(0.0);
+    }
+
     auto* desktop = QApplication::desktop();
     for (int i = 0; i < desktop->screenCount(); i++)
     {
@@ -332,6 +654,11 @@ void OfficeTooltip::showEvent(QShowEvent*)
         // actual widget, however, will be practically shown nonetheless.
         m_waitTimer->setInterval(m_waitPeriod);
         m_waitTimer->start();
+
+        if (m_fadeMode == LayerFade)
+        {
+            beginPrepareLayer();
+        }
     }
     else
     {
@@ -346,6 +673,8 @@ void OfficeTooltip::hideEvent(QHideEvent*)
         m_activeWindow->m_tooltipVisible = false;
     }
 
+    cancelPrepareLayer();
+
     m_timer->stop();
     m_waitTimer->stop();
     m_showAnimation->stop();
@@ -353,6 +682,7 @@ void OfficeTooltip::hideEvent(QHideEvent*)
 
     m_opacity = 0.0;
     m_isLinkHovered = false;
+    m_isLayerDirty  = true;
     m_activeWindow  = nullptr;
 }
 
@@ -381,7 +711,13 @@ void OfficeTooltip::fadeInTooltip()
     m_timer->setInterval(m_duration);
     m_timer->start();
 
-    updateRectangles();
+    // If the contents were prepared during the wait period, the tooltip can
+    // be faded in without any layout or rendering work.
+    if (!takePreparedLayer())
+    {
+        updateRectangles();
+        m_isLayerDirty = true;
+    }
 
     // Tells the active window that a tooltip was shown. This prevents the
     // OfficeWindow from rendering in "deactivated mode".
@@ -408,7 +744,7 @@ void OfficeTooltip::fadeInTooltip()
     activateWindow();
     setFocus(Qt::PopupFocusReason);
 
-    m_opacity = 0.0;
+    setOpacity(0.0);
     m_showAnimation->start();
 
     emit tooltipShown();
@@ -416,84 +752,91 @@ void OfficeTooltip::fadeInTooltip()
 
 void OfficeTooltip::updateRectangles()
 {
-    QFont normFont = font(); normFont.setBold(false);
-    QFont boldFont = font(); boldFont.setBold(true);
+    OffTraceScope("OfficeTooltip::layout");
 
-    QFontMetrics normMetrics(normFont);
-    QFontMetrics boldMetrics(boldFont);
-
-    int currentX = c_margin;
-    int currentY = c_margin;
+    const TooltipLayoutKey key = layoutKey(*this);
+    const priv::TooltipLayout* cached = g_layoutCache.object(key);
 
-    // Title
-    if (!m_heading.isEmpty())
+    if (cached != nullptr)
     {
-        QRect bounds = boldMetrics.boundingRect(m_heading);
-
-        m_headingRectangle.setX(currentX);
-        m_headingRectangle.setY(currentY);
-        m_headingRectangle.setSize(bounds.size() + QSize(5, 5));
-
-        currentY += (bounds.height() + c_bodyMargin);
+        applyLayout(*cached);
     }
-
-    // Body
-    if (!m_bodyText.isEmpty())
+    else
     {
-        QRect max(0, 0, width() - c_padding, 300);
-        QRect bounds = normMetrics.boundingRect(max, Qt::TextWordWrap, m_bodyText);
+        // The cache may evict the new entry right away; apply it beforehand.
+        applyLayout(computeLayout(key, font(), m_helpIcon.size()));
+        cacheLayout(key, m_layout);
+    }
+}
 
-        m_bodyRectangle.setX(currentX);
-        m_bodyRectangle.setY(currentY);
-        m_bodyRectangle.setSize(bounds.size());
+void OfficeTooltip::applyLayout(const priv::TooltipLayout& layout)
+{
+    m_layout = layout;
 
-        currentY += bounds.height();
-    }
+    resize(width(), layout.height);
+}
 
-    // Help
-    if (!m_helpText.isEmpty())
-    {
-        currentY += c_separator;
+void OfficeTooltip::beginPrepareLayer()
+{
+    cancelPrepareLayer();
 
-        // Separator
-        m_sepaRectangle.setX(currentX);
-        m_sepaRectangle.setY(currentY);
-        m_sepaRectangle.setSize(QSize(width() - c_padding, 1));
+    auto job = std::make_shared<priv::TooltipJob>();
+    job->key = layoutKey(*this);
+    job->font = font();
+    job->icon = m_helpImage;
+    job->helpEnabled = m_isHelpEnabled;
 
-        currentY += c_separator;
+    if (QFontDatabase::supportsThreadedFontRendering())
+    {
+        QThreadPool::globalInstance()->start(new priv::TooltipRunnable(job));
+    }
+    else
+    {
+        // Text can not be rendered outside of the GUI thread on this platform.
+        // Prepare as soon as the event loop is idle, still before fading in.
+        QTimer::singleShot(0, this, [job]() { prepareTooltip(*job); });
+    }
 
-        // Icon
-        m_iconRectangle.setX(currentX);
-        m_iconRectangle.setY(currentY);
-        m_iconRectangle.setSize(m_helpIcon.size());
+    m_job = job;
+}
 
-        currentX += (m_helpIcon.width() + c_iconMargin);
+void OfficeTooltip::cancelPrepareLayer()
+{
+    if (m_job)
+    {
+        // The job itself stays alive until the worker is done with it.
+        m_job->cancelled.store(true);
+        m_job.reset();
+    }
+}
 
-        // Text
-        m_helpRectangle.setX(currentX);
-        m_helpRectangle.setY(currentY);
-        m_helpRectangle.setWidth(boldMetrics.width(m_helpText));
-        m_helpRectangle.setHeight(boldMetrics.height());
+bool OfficeTooltip::takePreparedLayer()
+{
+    std::shared_ptr<priv::TooltipJob> job;
+    job.swap(m_job);
 
-        currentY += m_helpRectangle.height();
+    if (!job)
+    {
+        return false;
     }
 
-    currentY += c_margin;
-    resize(width(), currentY);
-    generateDropShadow();
+    // Contents may have changed during the wait period, e.g. if the tooltip
+    // was shown for another requester. Unfinished jobs are not waited for.
+    if (!job->finished.load(std::memory_order_acquire) ||
+        !(job->key == layoutKey(*this)) ||
+        job->helpEnabled != m_isHelpEnabled)
+    {
+        job->cancelled.store(true);
+        return false;
+    }
 
-    // Client
-    m_clientRectangle.setTopLeft(QPoint(c_shadowPadding, c_shadowPadding));
-    m_clientRectangle.setWidth(width() - c_shadowPadding * 2);
-    m_clientRectangle.setHeight(height() - c_shadowPadding * 2);
+    applyLayout(job->layout);
+    cacheLayout(job->key, job->layout);
 
-    // Border
-    m_borderRectangle = m_clientRectangle.adjusted(0,0,-1,-1);
-}
+    m_contentLayer = QPixmap::fromImage(job->layer);
+    m_isLayerDirty = false;
 
-void OfficeTooltip::generateDropShadow()
-{
-    m_dropShadow = OfficeImage::generateDropShadow(size());
+    return true;
 }
 
 qreal OfficeTooltip::opacity() const
@@ -503,5 +846,35 @@ qreal OfficeTooltip::opacity() const
 
 void OfficeTooltip::setOpacity(qreal opacity)
 {
+    OffTraceScope("OfficeTooltip::animate");
+
     m_opacity = opacity;
+
+    if (m_fadeMode == LayerFade && m_useWindowOpacity)
+    {
+        // The compositor blends the window; nothing needs to be repainted.
+        setWindowOpacity(opacity);
+    }
+    else
+    {
+        update();
+    }
+}
+
+void OfficeTooltip::renderLayer()
+{
+    OffTraceScope("OfficeTooltip::renderLayer");
+
+    const qreal ratio = devicePixelRatioF();
+
+    m_contentLayer = QPixmap(size() * ratio);
+    m_contentLayer.setDevicePixelRatio(ratio);
+    m_contentLayer.fill(Qt::transparent);
+    m_isLayerDirty = false;
+
+    if (!m_contentLayer.isNull())
+    {
+        QPainter painter(&m_contentLayer);
+        paintContent(painter);
+    }
 }
@@ -0,0 +1,170 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// QOffice - The office framework for Qt
+// Copyright (C) 2016-2018 Nicolas Kogler
+//
+// This file is part of the Widget module.
+//
+// QOffice is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// QOffice is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with QOffice. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QOffice/Widgets/OfficeTooltip.hpp>
+#include <QOffice/Widgets/OfficeTooltipManager.hpp>
+
+#include <QCoreApplication>
+
+static OfficeTooltipManager* g_tooltipManager = nullptr;
+
+OfficeTooltipContent::OfficeTooltipContent()
+    : helpKey(Qt::Key_F1)
+    , helpEnabled(false)
+    , duration(4000)
+    , waitPeriod(1000)
+{
+}
+
+OfficeTooltipManager::OfficeTooltipManager()
+    : QObject(nullptr)
+    , m_tooltip(nullptr)
+    , m_users(0)
+{
+}
+
+OfficeTooltipManager::~OfficeTooltipManager()
+{
+    // The tooltip is a top-level window without parent. Once the application
+    // is being destroyed, the widget state it depends on is already gone;
+    // normally, the tooltip was deleted when the application was about to quit.
+    if (QCoreApplication::instance() != nullptr)
+    {
+        delete m_tooltip;
+    }
+
+    if (g_tooltipManager == this)
+    {
+        g_tooltipManager = nullptr;
+    }
+}
+
+OfficeTooltipManager* OfficeTooltipManager::instance()
+{
+    if (g_tooltipManager == nullptr)
+    {
+        // Parented to the application so that it is destroyed along with it.
+        g_tooltipManager = new OfficeTooltipManager;
+        g_tooltipManager->setParent(QCoreApplication::instance());
+
+        // The manager outlives ~QApplication as one of its children; the
+        // tooltip widget must be gone before that.
+        QObject::connect(
+            QCoreApplication::instance(),
+            &QCoreApplication::aboutToQuit,
+            g_tooltipManager,
+            &OfficeTooltipManager::onAboutToQuit
+            );
+    }
+
+    return g_tooltipManager;
+}
+
+void OfficeTooltipManager::acquire()
+{
+    m_users++;
+}
+
+void OfficeTooltipManager::release()
+{
+    if (--m_users == 0 && m_tooltip != nullptr)
+    {
+        m_tooltip->deleteLater();
+        m_tooltip = nullptr;
+        m_requester = nullptr;
+    }
+}
+
+void OfficeTooltipManager::show(
+    QObject* requester,
+    const OfficeTooltipContent& content,
+    const QRect& geometry
+    )
+{
+    if (m_tooltip == nullptr)
+    {
+        // The native window is created lazily; most widgets never show their
+        // tooltip and many windows are never hovered at all.
+        m_tooltip = new OfficeTooltip;
+        m_defaultHelpIcon = m_tooltip->helpIcon();
+
+        QObject::connect(
+            m_tooltip,
+            &OfficeTooltip::helpRequested,
+            this,
+            &OfficeTooltipManager::onHelpRequested
+            );
+    }
+
+    // Hiding resets the timers and animations that belong to the previous
+    // requester before the contents are replaced.
+    m_tooltip->hide();
+    m_requester = requester;
+
+    m_tooltip->setTitle(content.title);
+    m_tooltip->setText(content.text);
+    m_tooltip->setHelpText(content.helpText);
+    m_tooltip->setHelpIcon(content.helpIcon.isNull() ? m_defaultHelpIcon : content.helpIcon);
+    m_tooltip->setHelpKey(content.helpKey);
+    m_tooltip->setHelpEnabled(content.helpEnabled);
+    m_tooltip->setDuration(content.duration);
+    m_tooltip->setWaitPeriod(content.waitPeriod);
+    m_tooltip->setGeometry(geometry);
+    m_tooltip->show();
+}
+
+void OfficeTooltipManager::hide(QObject* requester)
+{
+    if (m_tooltip != nullptr && m_requester == requester)
+    {
+        m_tooltip->hide();
+    }
+}
+
+bool OfficeTooltipManager::isShownFor(QObject* requester) const
+{
+    return m_tooltip != nullptr && m_tooltip->isVisible() && m_requester == requester;
+}
+
+QRect OfficeTooltipManager::geometry() const
+{
+    if (m_tooltip == nullptr || !m_tooltip->isVisible())
+    {
+        return QRect();
+    }
+
+    return m_tooltip->geometry();
+}
+
+void OfficeTooltipManager::onHelpRequested()
+{
+    if (m_requester != nullptr)
+    {
+        emit helpRequested(m_requester);
+    }
+}
+
+void OfficeTooltipManager::onAboutToQuit()
+{
+    delete m_tooltip;
+    m_requester = nullptr;
+}
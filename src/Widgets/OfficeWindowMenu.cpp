@@ -20,7 +20,7 @@
 //
 ////////////////////////////////////////////////////////////////////////////////
 
-#include <QOffice/Widgets/OfficeTooltip.hpp>
+#include <QOffice/Widgets/OfficeTooltipManager.hpp>
 #include <QOffice/Widgets/OfficeWindowMenu.hpp>
 #include <QOffice/Widgets/Dialogs/OfficeWindow.hpp>
 #include <QOffice/Widgets/Dialogs/OfficeWindowTitlebar.hpp>
@@ -34,18 +34,15 @@ OfficeWindowMenu::OfficeWindowMenu(priv::Titlebar* parent, Type type)
     : QWidget(parent),
       m_type(type)
     , m_parent(parent->m_window)
-    , m_tooltip(new OfficeTooltip)
 {
     setLayout(new QHBoxLayout(this));
 
-    // Prepare the timer that shows/hides the tooltip on demand.
-    m_tooltip->setHelpEnabled(true);
-    m_tooltip->setHelpText(tr("Press F1 to receive help."));
-    m_tooltip->setWaitPeriod(1000);
+    // All window menus share the tooltip window of the tooltip manager.
+    OfficeTooltipManager::instance()->acquire();
 
     QObject::connect(
-        m_tooltip,
-        &OfficeTooltip::helpRequested,
+        OfficeTooltipManager::instance(),
+        &OfficeTooltipManager::helpRequested,
         this,
         &OfficeWindowMenu::onHelpRequested
         );
@@ -74,7 +71,7 @@ OfficeWindowMenu::OfficeWindowMenu(priv::Titlebar* parent, Type type)
 
 OfficeWindowMenu::~OfficeWindowMenu()
 {
-    delete m_tooltip;
+    OfficeTooltipManager::instance()->release();
 }
 
 bool OfficeWindowMenu::addLabelItem(int id, const QString& t, const QString& tt)
@@ -116,7 +113,10 @@ bool OfficeWindowMenu::removeItem(int id)
 
 void OfficeWindowMenu::leaveEvent(QEvent*)
 {
-    m_tooltip->hide();
+    for (auto* item : m_items)
+    {
+        OfficeTooltipManager::instance()->hide(item);
+    }
 }
 
 void OfficeWindowMenu::onItemClicked(priv::WindowItem* item)
@@ -124,9 +124,14 @@ void OfficeWindowMenu::onItemClicked(priv::WindowItem* item)
     emit itemClicked(item->id());
 }
 
-void OfficeWindowMenu::onHelpRequested()
+void OfficeWindowMenu::onHelpRequested(QObject* requester)
 {
-    emit helpRequested(m_tooltip->property("item").toInt());
+    // The manager is shared; only react to tooltips of our own items.
+    auto* item = qobject_cast<priv::WindowItem*>(requester);
+    if (item != nullptr && m_items.contains(item))
+    {
+        emit helpRequested(item->id());
+    }
 }
 
 void OfficeWindowMenu::onShowTooltip(priv::WindowItem* item)
@@ -134,18 +139,22 @@ void OfficeWindowMenu::onShowTooltip(priv::WindowItem* item)
     QPoint pos = mapToGlobal(QPoint(item->width(), item->height()));
     QSize size(300, 200);
 
-    m_tooltip->setProperty("item", item->id());
-    m_tooltip->setGeometry(QRect(pos, size));
-    m_tooltip->setTitle(item->text());
-    m_tooltip->setText(item->tooltipText());
-    m_tooltip->show();
+    OfficeTooltipContent content;
+    content.title = item->text();
+    content.text = item->tooltipText();
+    content.helpText = tr("Press F1 to receive help.");
+    content.helpEnabled = true;
+    content.waitPeriod = 1000;
+
+    OfficeTooltipManager::instance()->show(item, content, QRect(pos, size));
 }
 
-void OfficeWindowMenu::onHideTooltip(priv::WindowItem*)
+void OfficeWindowMenu::onHideTooltip(priv::WindowItem* item)
 {
-    if (!m_tooltip->isVisible() || !m_tooltip->geometry().contains(QCursor::pos()))
+    auto* manager = OfficeTooltipManager::instance();
+    if (!manager->geometry().contains(QCursor::pos()))
     {
-        m_tooltip->hide();
+        manager->hide(item);
     }
 }
 
@@ -135,6 +135,8 @@ void priv::WindowItem::leaveEvent(QEvent* event)
 
 void priv::WindowItem::paintEvent(QPaintEvent*)
 {
+    OffTraceScope("WindowItem::paint");
+
     QPainter painter(this);
 
     if (m_type == OfficeWindowMenu::LabelMenu)
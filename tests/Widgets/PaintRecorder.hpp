@@ -0,0 +1,52 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// QOffice - The office framework for Qt
+// Copyright (C) 2016-2018 Nicolas Kogler
+//
+// This file is part of the Widget module.
+//
+// QOffice is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// QOffice is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with QOffice. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#ifndef QOFFICE_TESTS_WIDGETS_PAINTRECORDER_HPP
+#define QOFFICE_TESTS_WIDGETS_PAINTRECORDER_HPP
+
+#include <QEvent>
+#include <QPaintEvent>
+#include <QRegion>
+#include <QVector>
+
+// Records the region of every paint event delivered to the watched widgets.
+class PaintRecorder : public QObject
+{
+public:
+
+    QVector<QRegion> regions;
+
+protected:
+
+    bool eventFilter(QObject* watched, QEvent* event) override
+    {
+        if (event->type() == QEvent::Paint)
+        {
+            regions.append(static_cast<QPaintEvent*>(event)->region());
+        }
+
+        return QObject::eventFilter(watched, event);
+    }
+};
+
+#endif
@@ -0,0 +1,194 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// QOffice - The office framework for Qt
+// Copyright (C) 2016-2018 Nicolas Kogler
+//
+// This file is part of the Widget module.
+//
+// QOffice is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// QOffice is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with QOffice. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QOffice/Widgets/MenuItems/OfficeMenuDropdownItem.hpp>
+#include <QOffice/Widgets/OfficeMenu.hpp>
+#include <QOffice/Widgets/OfficeMenuHeader.hpp>
+#include <QOffice/Widgets/OfficeMenuPanel.hpp>
+
+#include <QApplication>
+#include <QListView>
+#include <QStringListModel>
+#include <QTest>
+
+static const QStringList c_fruits =
+{
+    "banana",
+    "Apple",
+    "apricot",
+    "Cherry",
+    "apple pie",
+    QString::fromUtf8("Äpfel"),
+    "APPLE"
+};
+
+class TestDropdown : public QObject
+{
+private slots:
+
+    void prefixFind_data();
+    void prefixFind();
+    void prefixFindRebuilds();
+    void typeAheadFollowsModelEdits();
+    void removingChoiceEmitsEvent_data();
+    void removingChoiceEmitsEvent();
+
+private:
+
+    void typeAhead(OfficeMenuDropdownItem*, const QString&);
+
+    Q_OBJECT
+};
+
+void TestDropdown::typeAhead(OfficeMenuDropdownItem* dropdown, const QString& text)
+{
+    // Keystrokes in quick succession extend the typed prefix; waits so that
+    // every call starts a new one.
+    QTest::qWait(QApplication::keyboardInputInterval() + 50);
+    dropdown->findChildren<QListView*>().last()->keyboardSearch(text);
+}
+
+void TestDropdown::prefixFind_data()
+{
+    QTest::addColumn<QString>("prefix");
+    QTest::addColumn<int>("row");
+
+    QTest::newRow("first of equal keys") << "apple" << 1;
+    QTest::newRow("folded") << "AP" << 1;
+    QTest::newRow("longer key") << "apple " << 4;
+    QTest::newRow("between keys") << "apr" << 2;
+    QTest::newRow("first key") << "b" << 0;
+    QTest::newRow("whole key") << "cherry" << 3;
+    QTest::newRow("non-ascii") << QString::fromUtf8("äP") << 5;
+    QTest::newRow("behind a key") << "bananas" << -1;
+    QTest::newRow("between keys, no match") << "d" << -1;
+    QTest::newRow("after all keys") << QString::fromUtf8("ö") << -1;
+    QTest::newRow("before all keys") << "0" << -1;
+}
+
+void TestDropdown::prefixFind()
+{
+    QFETCH(QString, prefix);
+    QFETCH(int, row);
+
+    QStringListModel model(c_fruits);
+    priv::PrefixIndex index;
+
+    QCOMPARE(index.find(&model, prefix), row);
+}
+
+void TestDropdown::prefixFindRebuilds()
+{
+    QStringListModel model(c_fruits);
+    priv::PrefixIndex index;
+
+    QCOMPARE(index.find(&model, "cherry"), 3);
+
+    // The index is a snapshot until it is invalidated.
+    model.setStringList({ "Cherry", "Date" });
+    QCOMPARE(index.find(&model, "date"), -1);
+
+    index.invalidate();
+    QCOMPARE(index.find(&model, "date"), 1);
+    QCOMPARE(index.find(&model, "cherry"), 0);
+    QCOMPARE(index.find(&model, "banana"), -1);
+}
+
+void TestDropdown::typeAheadFollowsModelEdits()
+{
+    OfficeMenuDropdownItem dropdown(QStringList({ "Alpha", "Beta" }));
+    QAbstractItemModel* model = dropdown.model();
+
+    typeAhead(&dropdown, "be");
+    QCOMPARE(dropdown.currentIndex(), 1);
+
+    // Rows inserted through the model are found right away.
+    QVERIFY(model->insertRow(2));
+    QVERIFY(model->setData(model->index(2, 0), "Gamma"));
+    typeAhead(&dropdown, "ga");
+    QCOMPARE(dropdown.currentIndex(), 2);
+    QCOMPARE(dropdown.currentText(), QString("Gamma"));
+
+    // The choice follows its row when rows in front of it are removed.
+    QVERIFY(model->removeRow(0));
+    QCOMPARE(dropdown.currentIndex(), 1);
+    QCOMPARE(dropdown.currentText(), QString("Gamma"));
+
+    // Changed texts are found by their new text only.
+    QVERIFY(model->setData(model->index(0, 0), "Delta"));
+    typeAhead(&dropdown, "be");
+    QCOMPARE(dropdown.currentIndex(), 1);
+    typeAhead(&dropdown, "de");
+    QCOMPARE(dropdown.currentIndex(), 0);
+}
+
+void TestDropdown::removingChoiceEmitsEvent_data()
+{
+    QTest::addColumn<bool>("ownsModel");
+
+    QTest::newRow("string list") << true;
+    QTest::newRow("external model") << false;
+}
+
+void TestDropdown::removingChoiceEmitsEvent()
+{
+    QFETCH(bool, ownsModel);
+
+    const QStringList items = { "Alpha", "Beta", "Gamma" };
+    QStringListModel external(items);
+
+    QWidget host;
+    OfficeMenu* menu = new OfficeMenu(&host);
+    OfficeMenuDropdownItem* dropdown = ownsModel
+        ? new OfficeMenuDropdownItem(items)
+        : new OfficeMenuDropdownItem(&external);
+
+    menu->appendHeader(0, "Home")->appendPanel(0, "Panel")->insertItem(1, dropdown, 0, 0);
+
+    QVector<int> events;
+    QObject::connect(menu, &OfficeMenu::itemChangedEvent,
+        [&events](OfficeMenuItemChangedEvent* event)
+            {
+                if (event->id() == 1)
+                    events.append(event->index());
+            });
+
+    QAbstractItemModel* model = dropdown->model();
+    typeAhead(dropdown, "be");
+    QCOMPARE(events, QVector<int>({ 1 }));
+
+    // Removing another row keeps the choice and reports nothing.
+    QVERIFY(model->removeRow(2));
+    QCOMPARE(events, QVector<int>({ 1 }));
+    QCOMPARE(dropdown->currentIndex(), 1);
+
+    // Removing the chosen row clears the choice, once.
+    QVERIFY(model->removeRow(1));
+    QCOMPARE(events, QVector<int>({ 1, -1 }));
+    QCOMPARE(dropdown->currentIndex(), -1);
+
+    QVERIFY(model->removeRow(0));
+    QCOMPARE(events, QVector<int>({ 1, -1 }));
+}
+
+QTEST_MAIN(TestDropdown)
+#include "TestDropdown.moc"
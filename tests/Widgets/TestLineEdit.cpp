@@ -0,0 +1,214 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// QOffice - The office framework for Qt
+// Copyright (C) 2016-2018 Nicolas Kogler
+//
+// This file is part of the Widget module.
+//
+// QOffice is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// QOffice is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with QOffice. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QOffice/Widgets/OfficeLineEdit.hpp>
+
+#include <QTest>
+
+class TestLineEdit : public QObject
+{
+private slots:
+
+    void init();
+    void cleanup();
+
+    void replaysEdits_data();
+    void replaysEdits();
+    void replaysOverlappingEdits();
+    void dropsCancellingEdits();
+    void coalescesUntilQuiet();
+    void flushesOnEditingFinished();
+
+private:
+
+    void create(const QString& text, int coalescePeriod);
+    void flush();
+
+    OfficeLineEdit* m_edit;
+    QString         m_replica;
+    int             m_edits;
+
+    Q_OBJECT
+};
+
+void TestLineEdit::init()
+{
+    m_edit = nullptr;
+    m_edits = 0;
+}
+
+void TestLineEdit::cleanup()
+{
+    delete m_edit;
+}
+
+void TestLineEdit::create(const QString& text, int coalescePeriod)
+{
+    m_edit = new OfficeLineEdit;
+    m_edit->setText(text);
+    m_edit->setCoalescePeriod(coalescePeriod);
+    m_edit->show();
+    QVERIFY(QTest::qWaitForWindowExposed(m_edit));
+
+    // Replays every reported edit on a copy of the initial text.
+    m_replica = text;
+    QObject::connect(m_edit, &OfficeLineEdit::contentEdited,
+        [this](int position, int removed, const QString& inserted)
+            {
+                QVERIFY(position >= 0 && removed >= 0);
+                QVERIFY(position + removed <= m_replica.size());
+
+                m_replica.replace(position, removed, inserted);
+                m_edits++;
+            });
+}
+
+void TestLineEdit::flush()
+{
+    // Finishing the edit reports whatever is pending right away.
+    if (m_edit->coalescePeriod() > 0)
+    {
+        QTest::keyClick(m_edit, Qt::Key_Return);
+    }
+}
+
+void TestLineEdit::replaysEdits_data()
+{
+    QTest::addColumn<int>("coalescePeriod");
+
+    QTest::newRow("immediate") << 0;
+    QTest::newRow("coalesced") << 60000;
+}
+
+void TestLineEdit::replaysEdits()
+{
+    QFETCH(int, coalescePeriod);
+    create("hello world", coalescePeriod);
+
+    // Appends.
+    QTest::keyClick(m_edit, Qt::Key_End);
+    QTest::keyClicks(m_edit, "!");
+    flush();
+    QCOMPARE(m_replica, m_edit->text());
+
+    // Prepends.
+    QTest::keyClick(m_edit, Qt::Key_Home);
+    QTest::keyClicks(m_edit, "> ");
+    flush();
+    QCOMPARE(m_replica, m_edit->text());
+
+    // Removes in the middle.
+    m_edit->setCursorPosition(6);
+    QTest::keyClick(m_edit, Qt::Key_Backspace);
+    QTest::keyClick(m_edit, Qt::Key_Backspace);
+    flush();
+    QCOMPARE(m_replica, m_edit->text());
+
+    // Replaces a selection.
+    m_edit->setSelection(2, 5);
+    QTest::keyClicks(m_edit, "XY");
+    flush();
+    QCOMPARE(m_replica, m_edit->text());
+
+    // Removes everything.
+    m_edit->selectAll();
+    QTest::keyClick(m_edit, Qt::Key_Backspace);
+    flush();
+    QCOMPARE(m_replica, m_edit->text());
+    QVERIFY(m_replica.isEmpty());
+}
+
+void TestLineEdit::replaysOverlappingEdits()
+{
+    create("aa", 0);
+
+    // Inserting a character that equals its neighbours makes the position of
+    // the edit ambiguous; any of them must replay to the same text.
+    QTest::keyClick(m_edit, Qt::Key_Home);
+    QTest::keyClicks(m_edit, "a");
+    QCOMPARE(m_replica, QString("aaa"));
+
+    m_edit->setCursorPosition(1);
+    QTest::keyClick(m_edit, Qt::Key_Delete);
+    QCOMPARE(m_replica, QString("aa"));
+
+    m_edit->setCursorPosition(1);
+    QTest::keyClicks(m_edit, "ba");
+    QCOMPARE(m_replica, m_edit->text());
+    QCOMPARE(m_edits, 4);
+}
+
+void TestLineEdit::dropsCancellingEdits()
+{
+    create("abc", 60000);
+
+    QTest::keyClick(m_edit, Qt::Key_End);
+    QTest::keyClicks(m_edit, "x");
+    QTest::keyClick(m_edit, Qt::Key_Backspace);
+    flush();
+
+    QCOMPARE(m_edits, 0);
+    QCOMPARE(m_replica, m_edit->text());
+}
+
+void TestLineEdit::coalescesUntilQuiet()
+{
+    create("abc", 50);
+
+    QString previous;
+    QString current;
+    QObject::connect(m_edit, &OfficeLineEdit::contentChanged,
+        [&previous, &current](QString p, QString c)
+            {
+                previous = p;
+                current = c;
+            });
+
+    QTest::keyClick(m_edit, Qt::Key_End);
+    QTest::keyClicks(m_edit, "def");
+    QCOMPARE(m_edits, 0);
+
+    QTRY_COMPARE(m_edits, 1);
+    QCOMPARE(m_replica, QString("abcdef"));
+    QCOMPARE(previous, QString("abc"));
+    QCOMPARE(current, QString("abcdef"));
+}
+
+void TestLineEdit::flushesOnEditingFinished()
+{
+    create("abc", 60000);
+
+    QTest::keyClick(m_edit, Qt::Key_Home);
+    QTest::keyClicks(m_edit, "xyz");
+    QCOMPARE(m_edits, 0);
+
+    emit m_edit->editingFinished();
+    QCOMPARE(m_edits, 1);
+    QCOMPARE(m_replica, QString("xyzabc"));
+
+    // Nothing is pending anymore.
+    emit m_edit->editingFinished();
+    QCOMPARE(m_edits, 1);
+}
+
+QTEST_MAIN(TestLineEdit)
+#include "TestLineEdit.moc"
@@ -0,0 +1,276 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// QOffice - The office framework for Qt
+// Copyright (C) 2016-2018 Nicolas Kogler
+//
+// This file is part of the Widget module.
+//
+// QOffice is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// QOffice is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with QOffice. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QOffice/Widgets/OfficeMenu.hpp>
+#include <QOffice/Widgets/OfficeMenuEvent.hpp>
+#include <QOffice/Widgets/OfficeMenuHeader.hpp>
+#include <QOffice/Widgets/OfficeMenuItem.hpp>
+#include <QOffice/Widgets/OfficeMenuPanel.hpp>
+
+#include <QStringList>
+#include <QTest>
+
+// An item that emits whatever event the test hands it.
+class EventItem
+    : public QWidget
+    , public OfficeMenuItem
+{
+public:
+
+    void emitTextChanged()
+    {
+        OfficeMenuTextChangedEvent event(id(), "old", "new");
+        emitItemEvent(&event);
+    }
+
+    void emitButtonClicked()
+    {
+        OfficeMenuButtonClickedEvent event(id(), false, false);
+        emitItemEvent(&event);
+    }
+
+    QWidget* widget() override
+    {
+        return this;
+    }
+};
+
+class TestMenuEvents : public QObject
+{
+private slots:
+
+    void init();
+    void cleanup();
+
+    void routesByItemAndType();
+    void keepsSubscriptionOrder();
+    void signalsReachSlots();
+    void unsubscribes();
+    void rejectsInvalidHandles();
+    void unsubscribesSelfDuringDispatch();
+    void unsubscribesOtherDuringDispatch();
+    void subscribesDuringDispatch();
+    void refusesDuplicateIds();
+
+private:
+
+    EventItem* item(int id);
+
+    QWidget*         m_host;
+    OfficeMenu*      m_menu;
+    OfficeMenuPanel* m_panel;
+    QStringList      m_calls;
+
+    Q_OBJECT
+};
+
+void TestMenuEvents::init()
+{
+    m_host = new QWidget;
+    m_menu = new OfficeMenu(m_host);
+    m_panel = m_menu->appendHeader(0, "Home")->appendPanel(0, "Panel");
+    m_calls.clear();
+
+    for (int i = 0; i < 3; i++)
+    {
+        m_panel->insertItem(i, new EventItem, 0, i);
+    }
+}
+
+void TestMenuEvents::cleanup()
+{
+    delete m_host;
+}
+
+EventItem* TestMenuEvents::item(int id)
+{
+    return static_cast<EventItem*>(m_panel->itemById(id));
+}
+
+void TestMenuEvents::routesByItemAndType()
+{
+    m_menu->subscribe(0, OfficeMenuEvent::TextChanged, [this](OfficeMenuEvent* event)
+        {
+            QCOMPARE(event->id(), 0);
+            QCOMPARE(event->type(), OfficeMenuEvent::TextChanged);
+            m_calls.append("text 0");
+        });
+
+    m_menu->subscribe(1, OfficeMenuEvent::TextChanged, [this](OfficeMenuEvent*) { m_calls.append("text 1"); });
+    m_menu->subscribe(0, OfficeMenuEvent::ButtonClicked, [this](OfficeMenuEvent*) { m_calls.append("button 0"); });
+
+    item(0)->emitTextChanged();
+    QCOMPARE(m_calls, QStringList({ "text 0" }));
+
+    item(0)->emitButtonClicked();
+    QCOMPARE(m_calls, QStringList({ "text 0", "button 0" }));
+
+    item(1)->emitTextChanged();
+    QCOMPARE(m_calls, QStringList({ "text 0", "button 0", "text 1" }));
+
+    // Neither the item nor the type of these events has a subscriber.
+    item(1)->emitButtonClicked();
+    item(2)->emitTextChanged();
+    QCOMPARE(m_calls.size(), 3);
+}
+
+void TestMenuEvents::keepsSubscriptionOrder()
+{
+    for (int i = 0; i < 3; i++)
+    {
+        m_menu->subscribe(0, OfficeMenuEvent::TextChanged, [this, i](OfficeMenuEvent*)
+            {
+                m_calls.append(QString::number(i));
+            });
+    }
+
+    item(0)->emitTextChanged();
+    QCOMPARE(m_calls, QStringList({ "0", "1", "2" }));
+}
+
+void TestMenuEvents::signalsReachSlots()
+{
+    m_menu->subscribe(0, OfficeMenuEvent::TextChanged, [this](OfficeMenuEvent*) { m_calls.append("handler"); });
+
+    QObject::connect(m_menu, &OfficeMenu::textChangedEvent, [this](OfficeMenuTextChangedEvent* event)
+        {
+            m_calls.append(QString("slot %1").arg(event->id()));
+        });
+
+    // Subscribed handlers come first; the signal reaches the slot regardless
+    // of any subscription.
+    item(0)->emitTextChanged();
+    item(1)->emitTextChanged();
+    QCOMPARE(m_calls, QStringList({ "handler", "slot 0", "slot 1" }));
+}
+
+void TestMenuEvents::unsubscribes()
+{
+    const int first = m_menu->subscribe(0, OfficeMenuEvent::TextChanged, [this](OfficeMenuEvent*) { m_calls.append("first"); });
+    const int second = m_menu->subscribe(0, OfficeMenuEvent::TextChanged, [this](OfficeMenuEvent*) { m_calls.append("second"); });
+    QVERIFY(first != second);
+
+    QVERIFY(m_menu->unsubscribe(first));
+    item(0)->emitTextChanged();
+    QCOMPARE(m_calls, QStringList({ "second" }));
+
+    QVERIFY(m_menu->unsubscribe(second));
+    item(0)->emitTextChanged();
+    QCOMPARE(m_calls, QStringList({ "second" }));
+}
+
+void TestMenuEvents::rejectsInvalidHandles()
+{
+    const int handle = m_menu->subscribe(0, OfficeMenuEvent::TextChanged, [this](OfficeMenuEvent*) { m_calls.append("handler"); });
+
+    QVERIFY(!m_menu->unsubscribe(-1));
+    QVERIFY(!m_menu->unsubscribe(handle + 1000));
+    QVERIFY(m_menu->unsubscribe(handle));
+    QVERIFY(!m_menu->unsubscribe(handle));
+
+    item(0)->emitTextChanged();
+    QVERIFY(m_calls.isEmpty());
+}
+
+void TestMenuEvents::unsubscribesSelfDuringDispatch()
+{
+    int handle = -1;
+    handle = m_menu->subscribe(0, OfficeMenuEvent::TextChanged, [this, &handle](OfficeMenuEvent*)
+        {
+            m_calls.append("once");
+            QVERIFY(m_menu->unsubscribe(handle));
+        });
+
+    m_menu->subscribe(0, OfficeMenuEvent::TextChanged, [this](OfficeMenuEvent*) { m_calls.append("always"); });
+
+    item(0)->emitTextChanged();
+    item(0)->emitTextChanged();
+    QCOMPARE(m_calls, QStringList({ "once", "always", "always" }));
+}
+
+void TestMenuEvents::unsubscribesOtherDuringDispatch()
+{
+    int later = -1;
+    m_menu->subscribe(0, OfficeMenuEvent::TextChanged, [this, &later](OfficeMenuEvent*)
+        {
+            m_calls.append("first");
+            m_menu->unsubscribe(later);
+        });
+
+    later = m_menu->subscribe(0, OfficeMenuEvent::TextChanged, [this](OfficeMenuEvent*) { m_calls.append("later"); });
+
+    // The later handler is already gone when its turn comes.
+    item(0)->emitTextChanged();
+    QCOMPARE(m_calls, QStringList({ "first" }));
+}
+
+void TestMenuEvents::subscribesDuringDispatch()
+{
+    bool hasSubscribed = false;
+    m_menu->subscribe(0, OfficeMenuEvent::TextChanged, [this, &hasSubscribed](OfficeMenuEvent*)
+        {
+            m_calls.append("first");
+
+            if (!hasSubscribed)
+            {
+                hasSubscribed = true;
+                m_menu->subscribe(0, OfficeMenuEvent::TextChanged, [this](OfficeMenuEvent*) { m_calls.append("new"); });
+            }
+        });
+
+    // A handler subscribed during a dispatch waits for the next event.
+    item(0)->emitTextChanged();
+    QCOMPARE(m_calls, QStringList({ "first" }));
+
+    item(0)->emitTextChanged();
+    QCOMPARE(m_calls, QStringList({ "first", "first", "new" }));
+}
+
+void TestMenuEvents::refusesDuplicateIds()
+{
+    EventItem* first = item(0);
+    EventItem* second = item(1);
+
+    // The entry of the other item stays intact.
+    QVERIFY(!second->setId(0));
+    QCOMPARE(second->id(), 1);
+    QCOMPARE(item(0), first);
+    QCOMPARE(item(1), second);
+
+    QVERIFY(second->setId(5));
+    QCOMPARE(item(5), second);
+    QVERIFY(item(1) == nullptr);
+
+    OfficeMenuHeader* header = m_menu->headerById(0);
+    OfficeMenuHeader* otherHeader = m_menu->appendHeader(1, "Insert");
+    QVERIFY(!otherHeader->setId(0));
+    QCOMPARE(m_menu->headerById(0), header);
+    QCOMPARE(m_menu->headerById(1), otherHeader);
+
+    OfficeMenuPanel* otherPanel = header->appendPanel(1, "Other");
+    QVERIFY(!otherPanel->setId(0));
+    QCOMPARE(header->panelById(0), m_panel);
+    QCOMPARE(header->panelById(1), otherPanel);
+}
+
+QTEST_MAIN(TestMenuEvents)
+#include "TestMenuEvents.moc"
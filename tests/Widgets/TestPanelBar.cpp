@@ -0,0 +1,245 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// QOffice - The office framework for Qt
+// Copyright (C) 2016-2018 Nicolas Kogler
+//
+// This file is part of the Widget module.
+//
+// QOffice is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// QOffice is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with QOffice. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QOffice/Widgets/OfficeMenu.hpp>
+#include <QOffice/Widgets/OfficeMenuHeader.hpp>
+#include <QOffice/Widgets/OfficeMenuItem.hpp>
+#include <QOffice/Widgets/OfficeMenuPanel.hpp>
+#include <QOffice/Widgets/OfficeMenuPanelBar.hpp>
+
+#include <QApplication>
+#include <QLayout>
+#include <QTest>
+
+static QOFFICE_CONSTEXPR int c_panelCount = 4;
+
+// An item of a fixed size, so that every panel has a known full width.
+class FixedItem
+    : public QWidget
+    , public OfficeMenuItem
+{
+public:
+
+    FixedItem(int width)
+    {
+        setFixedSize(width, 60);
+    }
+
+    QWidget* widget() override
+    {
+        return this;
+    }
+};
+
+class TestPanelBar : public QObject
+{
+private slots:
+
+    void init();
+    void cleanup();
+
+    void fitsWithoutCollapsing();
+    void collapsesRightToLeft();
+    void collapsesByPriority();
+    void expandsWhenWidened();
+    void releasesCollapsedPanel();
+
+private:
+
+    QVector<bool> collapsedAt(int width);
+    int requiredWidth() const;
+    int savedWidth(int panel) const;
+    bool isCollapsed(int panel) const;
+
+    QWidget*          m_host;
+    OfficeMenu*       m_menu;
+    OfficeMenuHeader* m_header;
+    priv::PanelBar*   m_bar;
+
+    Q_OBJECT
+};
+
+void TestPanelBar::init()
+{
+    m_host = new QWidget;
+    m_menu = new OfficeMenu(m_host);
+    m_header = m_menu->appendHeader(0, "Home");
+
+    for (int i = 0; i < c_panelCount; i++)
+    {
+        OfficeMenuPanel* panel = m_header->appendPanel(i, QString("P%1").arg(i));
+        panel->insertItem(i, new FixedItem(100 + i * 20), 0, 0);
+    }
+
+    m_bar = nullptr;
+    for (auto* child : m_menu->children())
+    {
+        if (auto* bar = dynamic_cast<priv::PanelBar*>(child))
+            m_bar = bar;
+    }
+
+    QVERIFY(m_bar != nullptr);
+
+    // Delivers the layout requests of the items to the panels.
+    QApplication::processEvents();
+    m_bar->invalidate();
+
+    // Measures the panels once, so that the widths below are known.
+    collapsedAt(10000);
+    QCOMPARE(m_bar->m_states.size(), c_panelCount);
+
+    for (int i = 0; i < c_panelCount; i++)
+    {
+        QVERIFY(savedWidth(i) > 0);
+    }
+}
+
+void TestPanelBar::cleanup()
+{
+    delete m_host;
+}
+
+QVector<bool> TestPanelBar::collapsedAt(int width)
+{
+    // The panel bar is hidden, hence it receives no resize event.
+    m_bar->resize(width, 90);
+    m_bar->adapt();
+
+    QVector<bool> collapsed;
+    for (const auto& state : m_bar->m_states)
+    {
+        collapsed.append(state.isCollapsed);
+    }
+
+    return collapsed;
+}
+
+int TestPanelBar::requiredWidth() const
+{
+    // The panels are laid out by the first layout of the panel bar; the pin
+    // button follows behind a spacer.
+    const QLayout* panels = m_bar->layout()->itemAt(0)->layout();
+    const int spacing = panels->spacing();
+    int width = m_bar->m_reservedWidth;
+
+    for (const auto& state : m_bar->m_states)
+    {
+        width += state.fullWidth + spacing;
+    }
+
+    return width;
+}
+
+int TestPanelBar::savedWidth(int panel) const
+{
+    const auto& state = m_bar->m_states.at(panel);
+    return state.fullWidth - state.reducedWidth;
+}
+
+bool TestPanelBar::isCollapsed(int panel) const
+{
+    // A collapsed panel lives in the popup of its button.
+    const auto& state = m_bar->m_states.at(panel);
+    const bool inBar = state.panel->parentWidget() == m_bar;
+
+    return state.isCollapsed && !inBar && state.button != nullptr && !state.button->isHidden();
+}
+
+void TestPanelBar::fitsWithoutCollapsing()
+{
+    const int required = requiredWidth();
+
+    QCOMPARE(collapsedAt(required), QVector<bool>({ false, false, false, false }));
+    QCOMPARE(collapsedAt(required - 1), QVector<bool>({ false, false, false, true }));
+    QVERIFY(isCollapsed(3));
+}
+
+void TestPanelBar::collapsesRightToLeft()
+{
+    const int required = requiredWidth();
+
+    // Each panel that collapses frees the difference to its button's width.
+    QCOMPARE(collapsedAt(required - savedWidth(3)), QVector<bool>({ false, false, false, true }));
+    QCOMPARE(collapsedAt(required - savedWidth(3) - 1), QVector<bool>({ false, false, true, true }));
+    QCOMPARE(collapsedAt(required - savedWidth(3) - savedWidth(2) - 1), QVector<bool>({ false, true, true, true }));
+    QCOMPARE(collapsedAt(0), QVector<bool>({ true, true, true, true }));
+
+    for (int i = 0; i < c_panelCount; i++)
+    {
+        QVERIFY(isCollapsed(i));
+    }
+}
+
+void TestPanelBar::collapsesByPriority()
+{
+    // Lower priorities collapse first, regardless of the position.
+    m_header->panelById(1)->setCollapsePriority(-1);
+    m_header->panelById(3)->setCollapsePriority(1);
+
+    const int required = requiredWidth();
+
+    QCOMPARE(collapsedAt(required - 1), QVector<bool>({ false, true, false, false }));
+    QCOMPARE(collapsedAt(required - savedWidth(1) - 1), QVector<bool>({ false, true, true, false }));
+    QCOMPARE(collapsedAt(required - savedWidth(1) - savedWidth(2) - 1), QVector<bool>({ true, true, true, false }));
+    QCOMPARE(collapsedAt(0), QVector<bool>({ true, true, true, true }));
+}
+
+void TestPanelBar::expandsWhenWidened()
+{
+    const int required = requiredWidth();
+
+    QCOMPARE(collapsedAt(0), QVector<bool>({ true, true, true, true }));
+    QCOMPARE(collapsedAt(required - savedWidth(3) - 1), QVector<bool>({ false, false, true, true }));
+    QCOMPARE(collapsedAt(required), QVector<bool>({ false, false, false, false }));
+
+    for (int i = 0; i < c_panelCount; i++)
+    {
+        const auto& state = m_bar->m_states.at(i);
+
+        QCOMPARE(state.panel->parentWidget(), static_cast<QWidget*>(m_bar));
+        QVERIFY(!state.panel->isHidden());
+        QVERIFY(state.button == nullptr || state.button->isHidden());
+    }
+}
+
+void TestPanelBar::releasesCollapsedPanel()
+{
+    const int required = requiredWidth();
+    const int saved = savedWidth(3);
+
+    QCOMPARE(collapsedAt(required - 1), QVector<bool>({ false, false, false, true }));
+    QVERIFY(m_header->removePanel(3));
+    QCOMPARE(m_bar->m_states.size(), c_panelCount - 1);
+
+    for (const auto& state : m_bar->m_states)
+    {
+        QVERIFY(state.panel != nullptr);
+        QVERIFY(!state.isCollapsed);
+    }
+
+    // The remaining panels fit into what the removed one left behind.
+    QCOMPARE(collapsedAt(required - saved), QVector<bool>({ false, false, false }));
+    QCOMPARE(collapsedAt(0), QVector<bool>({ true, true, true }));
+}
+
+QTEST_MAIN(TestPanelBar)
+#include "TestPanelBar.moc"
@@ -0,0 +1,239 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// QOffice - The office framework for Qt
+// Copyright (C) 2016-2018 Nicolas Kogler
+//
+// This file is part of the Widget module.
+//
+// QOffice is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// QOffice is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with QOffice. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QOffice/Widgets/OfficeMenuSearchIndex.hpp>
+
+#include <QStringList>
+#include <QTest>
+
+typedef OfficeMenuSearchIndex::Match Match;
+
+static QStringList textsOf(const QVector<Match>& matches)
+{
+    QStringList texts;
+    for (const Match& match : matches)
+    {
+        texts.append(match.text);
+    }
+
+    return texts;
+}
+
+class TestSearchIndex : public QObject
+{
+private slots:
+
+    void rankingTiers();
+    void ignoresCase();
+    void extendsPreviousQuery();
+    void extendsPreviousQueryAfterInsert();
+    void extendsPreviousQueryAfterRemove();
+    void reusesRemovedSlots();
+    void updatesText();
+    void limitsMatches();
+    void foldKeepsPositions();
+    void maskOfCharacters();
+
+private:
+
+    // The index never dereferences its owners; distinct addresses suffice.
+    OfficeMenuHeader* owner(int index);
+    void fill(OfficeMenuSearchIndex& index, const QStringList& texts);
+
+    char m_owners[64];
+
+    Q_OBJECT
+};
+
+OfficeMenuHeader* TestSearchIndex::owner(int index)
+{
+    return reinterpret_cast<OfficeMenuHeader*>(&m_owners[index]);
+}
+
+void TestSearchIndex::fill(OfficeMenuSearchIndex& index, const QStringList& texts)
+{
+    for (int i = 0; i < texts.size(); i++)
+    {
+        index.insert(texts.at(i), owner(i));
+    }
+}
+
+void TestSearchIndex::rankingTiers()
+{
+    OfficeMenuSearchIndex index;
+    fill(index, { "Print Circle", "Topic", "Table", "Insert Picture", "Picture Tools" });
+
+    // Prefix > word prefix > substring > subsequence; "Table" does not match.
+    const QVector<Match> matches = index.search("pic");
+    QCOMPARE(textsOf(matches), QStringList({ "Picture Tools", "Insert Picture", "Topic", "Print Circle" }));
+
+    for (int i = 1; i < matches.size(); i++)
+    {
+        QVERIFY(matches.at(i - 1).score > matches.at(i).score);
+    }
+
+    QCOMPARE(matches.first().header, owner(4));
+    QVERIFY(matches.first().panel == nullptr);
+    QVERIFY(matches.first().item == nullptr);
+}
+
+void TestSearchIndex::ignoresCase()
+{
+    OfficeMenuSearchIndex index;
+    fill(index, { "INSERT PICTURE", QString::fromUtf8("GrÖße") });
+
+    QCOMPARE(textsOf(index.search("insert")), QStringList({ "INSERT PICTURE" }));
+    QCOMPARE(textsOf(index.search("InSpIc")), QStringList({ "INSERT PICTURE" }));
+    QCOMPARE(textsOf(index.search(QString::fromUtf8("grö"))), QStringList({ QString::fromUtf8("GrÖße") }));
+}
+
+void TestSearchIndex::extendsPreviousQuery()
+{
+    const QStringList texts = { "Insert Picture", "Topic", "Print Circle", "Pictograph", "Spice" };
+
+    OfficeMenuSearchIndex incremental;
+    OfficeMenuSearchIndex fresh;
+    fill(incremental, texts);
+    fill(fresh, texts);
+
+    // Narrowing down the previous candidates yields what a full scan yields.
+    incremental.search("p");
+    incremental.search("pi");
+    QCOMPARE(textsOf(incremental.search("pic")), textsOf(fresh.search("pic")));
+    QCOMPARE(textsOf(incremental.search("pict")), textsOf(fresh.search("pict")));
+
+    // Going back is no extension and must find the dropped entries again.
+    QCOMPARE(textsOf(incremental.search("pi")), textsOf(fresh.search("pi")));
+    QVERIFY(textsOf(incremental.search("pi")).contains("Spice"));
+}
+
+void TestSearchIndex::extendsPreviousQueryAfterInsert()
+{
+    OfficeMenuSearchIndex index;
+    fill(index, { "Insert Picture", "Table" });
+
+    QCOMPARE(textsOf(index.search("pi")), QStringList({ "Insert Picture" }));
+
+    index.insert("Pie Chart", owner(2));
+    QCOMPARE(textsOf(index.search("pic")), QStringList({ "Insert Picture", "Pie Chart" }));
+}
+
+void TestSearchIndex::extendsPreviousQueryAfterRemove()
+{
+    OfficeMenuSearchIndex index;
+    fill(index, { "Insert Picture", "Topic" });
+
+    QCOMPARE(textsOf(index.search("pi")), QStringList({ "Insert Picture", "Topic" }));
+
+    QVERIFY(index.remove(owner(1)));
+    QVERIFY(!index.remove(owner(1)));
+    QCOMPARE(textsOf(index.search("pic")), QStringList({ "Insert Picture" }));
+}
+
+void TestSearchIndex::reusesRemovedSlots()
+{
+    OfficeMenuSearchIndex index;
+    fill(index, { "Alpha", "Beta", "Gamma" });
+
+    QVERIFY(index.remove(owner(1)));
+    QCOMPARE(index.size(), 2);
+
+    index.insert("Delta", owner(3));
+    QCOMPARE(index.size(), 3);
+    QCOMPARE(index.m_entries.size(), 3);
+
+    QVERIFY(index.search("beta").isEmpty());
+    QCOMPARE(textsOf(index.search("delta")), QStringList({ "Delta" }));
+
+    // Inserting for an owner that has an entry replaces it.
+    index.insert("Epsilon", owner(3));
+    QCOMPARE(index.size(), 3);
+    QCOMPARE(index.m_entries.size(), 3);
+    QVERIFY(index.search("delta").isEmpty());
+    QCOMPARE(textsOf(index.search("eps")), QStringList({ "Epsilon" }));
+
+    index.clear();
+    QCOMPARE(index.size(), 0);
+    QVERIFY(index.search("a").isEmpty());
+}
+
+void TestSearchIndex::updatesText()
+{
+    OfficeMenuSearchIndex index;
+    fill(index, { "Alpha", "Beta" });
+
+    QCOMPARE(textsOf(index.search("al")), QStringList({ "Alpha" }));
+    QVERIFY(index.update(owner(0), "Gamma"));
+    QVERIFY(!index.update(owner(5), "Delta"));
+
+    QVERIFY(index.search("alp").isEmpty());
+    QCOMPARE(textsOf(index.search("gam")), QStringList({ "Gamma" }));
+}
+
+void TestSearchIndex::limitsMatches()
+{
+    OfficeMenuSearchIndex index;
+    QStringList texts;
+    for (int i = 0; i < 20; i++)
+    {
+        texts.append(QString("Item %1").arg(i));
+    }
+
+    fill(index, texts);
+
+    const QStringList all = textsOf(index.search("item", 100));
+    QCOMPARE(all.size(), 20);
+    QCOMPARE(textsOf(index.search("item", 5)), all.mid(0, 5));
+    QCOMPARE(textsOf(index.search("item")).size(), 10);
+    QVERIFY(index.search("item", 0).isEmpty());
+    QVERIFY(index.search("  ").isEmpty());
+}
+
+void TestSearchIndex::foldKeepsPositions()
+{
+    const QString text = QString::fromUtf8("ÄBC Straße");
+    const QString folded = OfficeMenuSearchIndex::fold(text);
+
+    QCOMPARE(folded.size(), text.size());
+    QCOMPARE(folded, QString::fromUtf8("äbc straße"));
+}
+
+void TestSearchIndex::maskOfCharacters()
+{
+    QCOMPARE(OfficeMenuSearchIndex::maskOf("abc"), Q_UINT64_C(7));
+    QCOMPARE(OfficeMenuSearchIndex::maskOf("cab"), Q_UINT64_C(7));
+    QCOMPARE(OfficeMenuSearchIndex::maskOf("0"), Q_UINT64_C(1) << 26);
+    QCOMPARE(OfficeMenuSearchIndex::maskOf(""), Q_UINT64_C(0));
+
+    // Any other character lands in the upper bits, never in a letter's bit.
+    const quint64 other = OfficeMenuSearchIndex::maskOf(QString::fromUtf8("ä"));
+    QVERIFY(other != 0);
+    QCOMPARE(other & ((Q_UINT64_C(1) << 36) - 1), Q_UINT64_C(0));
+
+    // A text's mask covers the mask of every query that can match it.
+    const quint64 text = OfficeMenuSearchIndex::maskOf(OfficeMenuSearchIndex::fold("Insert Picture"));
+    const quint64 query = OfficeMenuSearchIndex::maskOf("inspic");
+    QCOMPARE(text & query, query);
+}
+
+QTEST_MAIN(TestSearchIndex)
+#include "TestSearchIndex.moc"
@@ -0,0 +1,300 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// QOffice - The office framework for Qt
+// Copyright (C) 2016-2018 Nicolas Kogler
+//
+// This file is part of the Widget module.
+//
+// QOffice is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// QOffice is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with QOffice. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QOffice/Widgets/Dialogs/OfficeWindow.hpp>
+#include <QOffice/Widgets/Dialogs/OfficeWindowTitlebar.hpp>
+#include "PaintRecorder.hpp"
+
+#include <QApplication>
+#include <QBoxLayout>
+#include <QFontInfo>
+#include <QTest>
+
+typedef priv::Titlebar Titlebar;
+
+static bool isWithin(const QRegion& region, const QRegion& bounds)
+{
+    return region.subtracted(bounds).isEmpty();
+}
+
+class TestTitlebar : public QObject
+{
+private slots:
+
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+
+    void transitionHover();
+    void transitionCapturedPress();
+    void transitionRelease();
+    void paintOnlyChangedButtons();
+    void paintCapturedPress();
+    void elideAfterFontChange();
+
+private:
+
+    QRect buttonRect(Titlebar::Button) const;
+    QPoint buttonCenter(Titlebar::Button) const;
+    QPoint dragPoint() const;
+    Titlebar::ButtonState state(Titlebar::Button) const;
+
+    void moveMouse(const QPoint&);
+    void flush();
+
+    OfficeWindow* m_window;
+    Titlebar*     m_titlebar;
+    PaintRecorder m_recorder;
+
+    Q_OBJECT
+};
+
+void TestTitlebar::initTestCase()
+{
+    m_window = new OfficeWindow;
+    m_window->resize(800, 600);
+    m_window->setWindowTitle("Test");
+    m_window->setLayout(new QVBoxLayout);
+    m_window->show();
+    QVERIFY(QTest::qWaitForWindowExposed(m_window));
+
+    m_titlebar = nullptr;
+    for (auto* child : m_window->children())
+    {
+        if (auto* titlebar = dynamic_cast<Titlebar*>(child))
+            m_titlebar = titlebar;
+    }
+
+    QVERIFY(m_titlebar != nullptr);
+    m_titlebar->installEventFilter(&m_recorder);
+
+    for (int i = 0; i < Titlebar::ButtonCount; i++)
+    {
+        QVERIFY(!buttonRect(static_cast<Titlebar::Button>(i)).isEmpty());
+    }
+}
+
+void TestTitlebar::cleanupTestCase()
+{
+    delete m_window;
+}
+
+void TestTitlebar::init()
+{
+    m_titlebar->transition(Titlebar::EventLeave, QPoint(-1, -1));
+    flush();
+    m_recorder.regions.clear();
+}
+
+void TestTitlebar::transitionHover()
+{
+    const QRect close = buttonRect(Titlebar::CloseButton);
+    const QRect maximize = buttonRect(Titlebar::MaximizeButton);
+
+    // Entering a button only dirties that button.
+    QCOMPARE(m_titlebar->transition(Titlebar::EventMove, buttonCenter(Titlebar::CloseButton)), QRegion(close));
+    QCOMPARE(state(Titlebar::CloseButton), Titlebar::ButtonHover);
+
+    // Moving within the same button dirties nothing.
+    QCOMPARE(m_titlebar->transition(Titlebar::EventMove, buttonCenter(Titlebar::CloseButton) + QPoint(1, 1)), QRegion());
+
+    // Moving to the neighbour dirties both buttons.
+    QCOMPARE(m_titlebar->transition(Titlebar::EventMove, buttonCenter(Titlebar::MaximizeButton)), QRegion(close) + maximize);
+    QCOMPARE(state(Titlebar::CloseButton), Titlebar::ButtonNone);
+    QCOMPARE(state(Titlebar::MaximizeButton), Titlebar::ButtonHover);
+
+    // Leaving the buttons dirties the hovered one only.
+    QCOMPARE(m_titlebar->transition(Titlebar::EventMove, dragPoint()), QRegion(maximize));
+    QCOMPARE(m_titlebar->transition(Titlebar::EventMove, dragPoint()), QRegion());
+    QCOMPARE(m_titlebar->transition(Titlebar::EventLeave, QPoint(-1, -1)), QRegion());
+}
+
+void TestTitlebar::transitionCapturedPress()
+{
+    const QRect maximize = buttonRect(Titlebar::MaximizeButton);
+
+    m_titlebar->transition(Titlebar::EventMove, buttonCenter(Titlebar::MaximizeButton));
+    QCOMPARE(m_titlebar->transition(Titlebar::EventPress, buttonCenter(Titlebar::MaximizeButton)), QRegion(maximize));
+    QCOMPARE(state(Titlebar::MaximizeButton), Titlebar::ButtonPress);
+
+    // While pressed, the other buttons are not hovered and only the pressed
+    // one toggles between pressed and "special".
+    QCOMPARE(m_titlebar->transition(Titlebar::EventMove, buttonCenter(Titlebar::MinimizeButton)), QRegion(maximize));
+    QCOMPARE(state(Titlebar::MaximizeButton), Titlebar::ButtonSpecial);
+    QCOMPARE(state(Titlebar::MinimizeButton), Titlebar::ButtonNone);
+
+    QCOMPARE(m_titlebar->transition(Titlebar::EventMove, buttonCenter(Titlebar::CloseButton)), QRegion());
+    QCOMPARE(state(Titlebar::CloseButton), Titlebar::ButtonNone);
+
+    QCOMPARE(m_titlebar->transition(Titlebar::EventMove, buttonCenter(Titlebar::MaximizeButton)), QRegion(maximize));
+    QCOMPARE(state(Titlebar::MaximizeButton), Titlebar::ButtonPress);
+}
+
+void TestTitlebar::transitionRelease()
+{
+    const QRect close = buttonRect(Titlebar::CloseButton);
+    const QRect minimize = buttonRect(Titlebar::MinimizeButton);
+    Titlebar::Button triggered;
+
+    // Released outside of the pressed button: nothing fires.
+    m_titlebar->transition(Titlebar::EventPress, buttonCenter(Titlebar::MinimizeButton));
+    m_titlebar->transition(Titlebar::EventMove, buttonCenter(Titlebar::CloseButton));
+    QCOMPARE(m_titlebar->transition(Titlebar::EventRelease, buttonCenter(Titlebar::CloseButton), &triggered), QRegion(minimize));
+    QCOMPARE(triggered, Titlebar::NoButton);
+
+    // Released on the pressed button: the button fires. The transition only
+    // reports it; the action itself is not run by this test.
+    QCOMPARE(m_titlebar->transition(Titlebar::EventPress, buttonCenter(Titlebar::CloseButton)), QRegion(close));
+    QCOMPARE(m_titlebar->transition(Titlebar::EventRelease, buttonCenter(Titlebar::CloseButton), &triggered), QRegion(close));
+    QCOMPARE(triggered, Titlebar::CloseButton);
+
+    for (int i = 0; i < Titlebar::ButtonCount; i++)
+    {
+        QCOMPARE(state(static_cast<Titlebar::Button>(i)), Titlebar::ButtonNone);
+    }
+}
+
+void TestTitlebar::paintOnlyChangedButtons()
+{
+    const QRect close = buttonRect(Titlebar::CloseButton);
+    const QRect minimize = buttonRect(Titlebar::MinimizeButton);
+
+    moveMouse(dragPoint());
+    QCOMPARE(m_recorder.regions.size(), 0);
+
+    moveMouse(buttonCenter(Titlebar::CloseButton));
+    QCOMPARE(m_recorder.regions.size(), 1);
+    QVERIFY(isWithin(m_recorder.regions.last(), close));
+
+    // A stream of moves within the hovered button paints nothing.
+    for (int x = -3; x <= 3; x++)
+    {
+        moveMouse(buttonCenter(Titlebar::CloseButton) + QPoint(x, 0));
+    }
+
+    QCOMPARE(m_recorder.regions.size(), 1);
+
+    moveMouse(buttonCenter(Titlebar::MinimizeButton));
+    QCOMPARE(m_recorder.regions.size(), 2);
+    QVERIFY(isWithin(m_recorder.regions.last(), QRegion(close) + minimize));
+
+    moveMouse(dragPoint());
+    QCOMPARE(m_recorder.regions.size(), 3);
+    QVERIFY(isWithin(m_recorder.regions.last(), minimize));
+}
+
+void TestTitlebar::paintCapturedPress()
+{
+    const QRect minimize = buttonRect(Titlebar::MinimizeButton);
+    const QPoint center = buttonCenter(Titlebar::MinimizeButton);
+
+    moveMouse(center);
+    QTest::mousePress(m_titlebar, Qt::LeftButton, Qt::NoModifier, center);
+    flush();
+    QCOMPARE(m_recorder.regions.size(), 2);
+    QVERIFY(isWithin(m_recorder.regions.last(), minimize));
+
+    // Dragging the pressed button across the others only repaints itself.
+    moveMouse(buttonCenter(Titlebar::MaximizeButton));
+    moveMouse(buttonCenter(Titlebar::CloseButton));
+    QCOMPARE(m_recorder.regions.size(), 3);
+    QVERIFY(isWithin(m_recorder.regions.last(), minimize));
+
+    // Releasing outside of the button does not minimize the window.
+    QTest::mouseRelease(m_titlebar, Qt::LeftButton, Qt::NoModifier, buttonCenter(Titlebar::CloseButton));
+    flush();
+    QCOMPARE(m_recorder.regions.size(), 4);
+    QVERIFY(isWithin(m_recorder.regions.last(), minimize));
+    QVERIFY(m_window->isVisible());
+    QVERIFY(!m_window->isMinimized());
+
+    for (int i = 0; i < Titlebar::ButtonCount; i++)
+    {
+        QCOMPARE(state(static_cast<Titlebar::Button>(i)), Titlebar::ButtonNone);
+    }
+}
+
+QRect TestTitlebar::buttonRect(Titlebar::Button button) const
+{
+    return m_titlebar->m_layout->buttonRectangles[button];
+}
+
+QPoint TestTitlebar::buttonCenter(Titlebar::Button button) const
+{
+    return buttonRect(button).center();
+}
+
+QPoint TestTitlebar::dragPoint() const
+{
+    return m_titlebar->m_layout->dragRectangle.center();
+}
+
+Titlebar::ButtonState TestTitlebar::state(Titlebar::Button button) const
+{
+    return m_titlebar->m_buttonStates[button];
+}
+
+void TestTitlebar::elideAfterFontChange()
+{
+    const QFont font = m_titlebar->font();
+    m_window->setWindowTitle(QString("Document ").repeated(8));
+    const QString visibleTitle = m_titlebar->m_layout->visibleTitle;
+    QVERIFY(!visibleTitle.isEmpty());
+
+    // The title is elided again with the metrics of the new font, although
+    // neither the size nor the title changed.
+    QFont larger = font;
+    larger.setPointSizeF(QFontInfo(font).pointSizeF() * 4);
+    m_titlebar->setFont(larger);
+    QVERIFY(m_titlebar->m_layout->visibleTitle != visibleTitle);
+
+    m_titlebar->setFont(font);
+    QCOMPARE(m_titlebar->m_layout->visibleTitle, visibleTitle);
+
+    m_window->setWindowTitle("Test");
+}
+
+void TestTitlebar::moveMouse(const QPoint& pos)
+{
+    // Delivered directly to the titlebar, like QTest::mousePress does; this
+    // neither depends on nor moves the real cursor.
+    QMouseEvent event(
+        QEvent::MouseMove,
+        pos,
+        m_titlebar->mapToGlobal(pos),
+        Qt::NoButton,
+        Qt::NoButton,
+        Qt::NoModifier
+        );
+
+    QApplication::sendEvent(m_titlebar, &event);
+    flush();
+}
+
+void TestTitlebar::flush()
+{
+    // Delivers the pending update requests, hence the paint events.
+    QApplication::processEvents();
+}
+
+QTEST_MAIN(TestTitlebar)
+#include "TestTitlebar.moc"
@@ -0,0 +1,108 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// QOffice - The office framework for Qt
+// Copyright (C) 2016-2018 Nicolas Kogler
+//
+// This file is part of the Widget module.
+//
+// QOffice is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// QOffice is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with QOffice. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QOffice/Widgets/Dialogs/OfficeWindow.hpp>
+#include <QOffice/Widgets/Dialogs/OfficeWindowTitlebar.hpp>
+#include "PaintRecorder.hpp"
+
+#include <QApplication>
+#include <QBoxLayout>
+#include <QTest>
+
+class TestWindow : public QObject
+{
+private slots:
+
+    void initTestCase();
+    void cleanupTestCase();
+
+    void toggleMaximizedPaintsTitlebarOnce();
+
+private:
+
+    void settle();
+
+    OfficeWindow* m_window;
+    QWidget*      m_titlebar;
+    PaintRecorder m_recorder;
+
+    Q_OBJECT
+};
+
+void TestWindow::initTestCase()
+{
+    m_window = new OfficeWindow;
+    m_window->resize(640, 480);
+    m_window->setWindowTitle("Test");
+    m_window->setLayout(new QVBoxLayout);
+    m_window->show();
+    QVERIFY(QTest::qWaitForWindowExposed(m_window));
+
+    m_titlebar = nullptr;
+    for (auto* child : m_window->children())
+    {
+        if (auto* titlebar = dynamic_cast<priv::Titlebar*>(child))
+            m_titlebar = titlebar;
+    }
+
+    QVERIFY(m_titlebar != nullptr);
+    m_titlebar->installEventFilter(&m_recorder);
+    settle();
+}
+
+void TestWindow::cleanupTestCase()
+{
+    delete m_window;
+}
+
+void TestWindow::toggleMaximizedPaintsTitlebarOnce()
+{
+    for (int i = 0; i < 3; i++)
+    {
+        m_recorder.regions.clear();
+        m_window->showMaximized();
+        QTRY_VERIFY(m_window->isMaximized());
+        settle();
+
+        QVERIFY2(m_recorder.regions.size() <= 1, qPrintable(
+            QString("maximize painted the titlebar %1 times").arg(m_recorder.regions.size())));
+
+        m_recorder.regions.clear();
+        m_window->showNormal();
+        QTRY_VERIFY(!m_window->isMaximized());
+        settle();
+
+        QVERIFY2(m_recorder.regions.size() <= 1, qPrintable(
+            QString("restore painted the titlebar %1 times").arg(m_recorder.regions.size())));
+    }
+}
+
+void TestWindow::settle()
+{
+    // Gives the resize, the layout and the scheduled update a chance to run;
+    // any additional repaint caused by the state change lands in this window.
+    QTest::qWait(100);
+    QApplication::processEvents();
+}
+
+QTEST_MAIN(TestWindow)
+#include "TestWindow.moc"